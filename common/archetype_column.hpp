@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <type_traits>
+
+#include <madrona/ecs.hpp>
+
+namespace run {
+
+namespace detail {
+
+template <typename ComponentT, typename... ComponentTs>
+constexpr int32_t archetypeColumn(const madrona::Archetype<ComponentTs...> *)
+{
+    static_assert((std::is_same_v<ComponentT, ComponentTs> || ...),
+                  "Component is not part of the archetype");
+
+    int32_t col = 2;
+    ((std::is_same_v<ComponentT, ComponentTs> ? false : (col++, true)) && ...);
+    return col;
+}
+
+}
+
+// Column of ComponentT in ArchetypeT for Context::getDirect, following the
+// Entity and WorldID columns every archetype starts with. Derived from the
+// archetype declaration, so reordering its components can't leave direct
+// writes pointing at the wrong column.
+template <typename ArchetypeT, typename ComponentT>
+inline constexpr int32_t archetypeColumn =
+    detail::archetypeColumn<ComponentT>((const ArchetypeT *)nullptr);
+
+}
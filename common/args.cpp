@@ -52,17 +52,20 @@ ViewerRunArgs parseViewerArgs(int argc, char **argv)
 HeadlessRunArgs parseHeadlessArgs(int argc, char **argv)
 {
     auto usage_err = [argv]() {
-        fprintf(stderr, "%s [NUM_WORLDS] [NUM_STEPS] [rt|rast] [BATCH_WIDTH] [BATCH_HEIGHT] [--dump-last-frame file_name_without_extension]\n", argv[0]);
+        fprintf(stderr, "%s [NUM_WORLDS] [NUM_STEPS] [rt|rast] [BATCH_WIDTH] [BATCH_HEIGHT] [--dump-last-frame file_name_without_extension] [--exec cpu|cuda] [extra...]\n", argv[0]);
         exit(EXIT_FAILURE);
     };
 
     HeadlessRunArgs run_args = {};
     run_args.dumpOutputFile = false;
+    run_args.execBackend = ExecBackend::CUDA;
 
-    if (argc != 6 && argc != 8) {
+    if (argc < 6) {
         usage_err();
     }
 
+    int extra_arg_idx = -1;
+
     run_args.argCounter = 0;
     for (int i = 1; i < argc; ++i) {
         char *arg = argv[i];
@@ -84,16 +87,32 @@ HeadlessRunArgs parseHeadlessArgs(int argc, char **argv)
             run_args.batchRenderWidth = std::stoi(arg);
         } else if (i == 5) {
             run_args.batchRenderHeight = std::stoi(arg);
-        } else if (i == 6) {
-            if (!strcmp("--dump-last-frame", arg)) {
-                run_args.dumpOutputFile = true;
+        } else if (i + 1 < argc && !strcmp("--dump-last-frame", arg)) {
+            run_args.dumpOutputFile = true;
+            run_args.outputFileName = std::string(argv[++i]);
+            ++run_args.argCounter;
+        } else if (i + 1 < argc && !strcmp("--exec", arg)) {
+            char *backend = argv[++i];
+            ++run_args.argCounter;
+
+            if (!strcmp("cpu", backend)) {
+                run_args.execBackend = ExecBackend::CPU;
+            } else if (!strcmp("cuda", backend)) {
+                run_args.execBackend = ExecBackend::CUDA;
+            } else {
+                usage_err();
             }
-        } else if (i == 7) {
-            std::string output_file = std::string(arg);
-            run_args.outputFileName = output_file;
+        } else {
+            // Extra app-specific argument, left for the caller
+            extra_arg_idx = i;
         }
     }
 
+    // argCounter is the index of the last extra argument, if any
+    if (extra_arg_idx != -1) {
+        run_args.argCounter = extra_arg_idx;
+    }
+
     return run_args;
 }
 
@@ -10,6 +10,11 @@ enum class RenderMode {
     Rasterizer
 };
 
+enum class ExecBackend {
+    CUDA,
+    CPU
+};
+
 struct ViewerRunArgs {
     uint32_t numWorlds;
 
@@ -37,6 +42,9 @@ struct HeadlessRunArgs {
     bool dumpOutputFile;
     std::string outputFileName;
 
+    // --exec cpu|cuda, defaults to CUDA
+    ExecBackend execBackend;
+
     uint32_t argCounter;
 };
 
@@ -0,0 +1,580 @@
+#include "asset_cache.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace madrona;
+
+namespace run {
+
+namespace {
+
+// Bump when the layout below or the way assets are imported changes.
+constexpr uint32_t cacheVersion = 1;
+constexpr char cacheMagic[8] = { 'M', 'A', 'D', 'A', 'S', 'S', 'E', 'T' };
+
+struct CacheRange {
+    uint64_t offset;
+    uint64_t numBytes;
+};
+
+struct CacheDependency {
+    CacheRange path;
+    uint64_t stamp;
+};
+
+struct CacheObject {
+    uint32_t meshOffset;
+    uint32_t numMeshes;
+};
+
+// Offsets of 0 encode null pointers (offset 0 is always the header)
+struct CacheMesh {
+    uint64_t positions;
+    uint64_t normals;
+    uint64_t tangentAndSigns;
+    uint64_t uvs;
+    uint64_t indices;
+    uint64_t faceCounts;
+    uint64_t faceMaterials;
+    uint32_t numVertices;
+    uint32_t numFaces;
+    uint32_t materialIDX;
+    uint32_t pad;
+};
+
+struct CacheTexture {
+    CacheRange data;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pad;
+};
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t materialStride;
+    uint64_t key;
+    uint64_t totalBytes;
+
+    uint32_t numSections;
+    uint32_t numDependencies;
+    uint32_t numObjects;
+    uint32_t numMeshes;
+    uint32_t numMaterials;
+    uint32_t numTextures;
+
+    uint64_t sectionsOffset;
+    uint64_t dependenciesOffset;
+    uint64_t objectsOffset;
+    uint64_t meshesOffset;
+    uint64_t materialsOffset;
+    uint64_t texturesOffset;
+};
+
+class BlobWriter {
+public:
+    inline BlobWriter()
+        : buf_(sizeof(CacheHeader))
+    {}
+
+    inline uint64_t append(const void *data, uint64_t num_bytes,
+                           uint64_t alignment = 16)
+    {
+        if (data == nullptr) {
+            return 0;
+        }
+
+        uint64_t offset = (buf_.size() + alignment - 1) & ~(alignment - 1);
+        buf_.resize(offset + num_bytes);
+        if (num_bytes > 0) {
+            memcpy(buf_.data() + offset, data, num_bytes);
+        }
+
+        return offset;
+    }
+
+    template <typename T>
+    inline uint64_t appendArray(const std::vector<T> &v)
+    {
+        return append(v.data(), sizeof(T) * v.size());
+    }
+
+    inline std::vector<char> & buffer() { return buf_; }
+
+private:
+    std::vector<char> buf_;
+};
+
+uint32_t numMeshIndices(const imp::SourceMesh &mesh)
+{
+    if (mesh.faceCounts == nullptr) {
+        return mesh.numFaces * 3;
+    }
+
+    uint32_t num_indices = 0;
+    for (uint32_t i = 0; i < mesh.numFaces; i++) {
+        num_indices += mesh.faceCounts[i];
+    }
+
+    return num_indices;
+}
+
+uint64_t textureNumBytes(const imp::SourceTexture &tex)
+{
+    if (tex.format == imp::SourceTextureFormat::BC7) {
+        return tex.numBytes;
+    }
+
+    return tex.numBytes > 0 ? tex.numBytes :
+        (uint64_t)tex.width * (uint64_t)tex.height * 4;
+}
+
+template <typename T>
+T * mappedPtr(char *base, uint64_t offset)
+{
+    return offset == 0 ? nullptr : (T *)(base + offset);
+}
+
+bool rangeInBounds(uint64_t offset, uint64_t num_bytes, uint64_t total)
+{
+    return offset <= total && num_bytes <= total - offset;
+}
+
+// Offset 0 is a null pointer, anything else must fit num_elems elements
+bool arrayInBounds(uint64_t offset, uint64_t num_elems, uint64_t elem_bytes,
+                   uint64_t total)
+{
+    return offset == 0 || (num_elems <= total / elem_bytes &&
+        rangeInBounds(offset, num_elems * elem_bytes, total));
+}
+
+// Checks every array a cached mesh points to against the mapping, including
+// the index count implied by its face counts
+bool meshInBounds(const char *base, const CacheMesh &mesh, uint64_t total)
+{
+    uint64_t num_verts = mesh.numVertices;
+    uint64_t num_faces = mesh.numFaces;
+
+    if (!arrayInBounds(mesh.positions, num_verts,
+                       sizeof(math::Vector3), total) ||
+            !arrayInBounds(mesh.normals, num_verts,
+                           sizeof(math::Vector3), total) ||
+            !arrayInBounds(mesh.tangentAndSigns, num_verts,
+                           sizeof(math::Vector4), total) ||
+            !arrayInBounds(mesh.uvs, num_verts,
+                           sizeof(math::Vector2), total) ||
+            !arrayInBounds(mesh.faceCounts, num_faces,
+                           sizeof(uint32_t), total) ||
+            !arrayInBounds(mesh.faceMaterials, num_faces,
+                           sizeof(uint32_t), total)) {
+        return false;
+    }
+
+    uint64_t num_indices = num_faces * 3;
+    if (mesh.faceCounts != 0) {
+        uint32_t face_count;
+        num_indices = 0;
+        for (uint64_t i = 0; i < num_faces; i++) {
+            memcpy(&face_count, base + mesh.faceCounts + i * sizeof(uint32_t),
+                   sizeof(uint32_t));
+            num_indices += face_count;
+        }
+    }
+
+    return arrayInBounds(mesh.indices, num_indices, sizeof(uint32_t), total);
+}
+
+}
+
+uint64_t hashBytes(const void *data, size_t num_bytes, uint64_t seed)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t hash = seed;
+    for (size_t i = 0; i < num_bytes; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+uint64_t hashString(std::string_view str, uint64_t seed)
+{
+    // Hash the length too, so concatenated strings don't collide
+    seed = hashValue((uint64_t)str.size(), seed);
+    return hashBytes(str.data(), str.size(), seed);
+}
+
+uint64_t hashFileStamp(const std::filesystem::path &path, uint64_t seed)
+{
+    seed = hashString(path.string(), seed);
+
+    std::error_code err;
+    uint64_t num_bytes = std::filesystem::file_size(path, err);
+    if (err) {
+        return hashValue(~0ull, seed);
+    }
+
+    auto mod_time = std::filesystem::last_write_time(path, err);
+    if (err) {
+        return hashValue(~0ull, seed);
+    }
+
+    seed = hashValue(num_bytes, seed);
+    return hashValue((int64_t)mod_time.time_since_epoch().count(), seed);
+}
+
+bool writeFileAtomic(const std::filesystem::path &path,
+                     const void *data, size_t num_bytes,
+                     const char *what)
+{
+    std::error_code err;
+    std::filesystem::create_directories(path.parent_path(), err);
+
+    std::filesystem::path tmp_path = path;
+    tmp_path.concat("." + std::to_string(getpid()) + ".tmp");
+
+    {
+        std::ofstream out(tmp_path, std::ios::binary);
+        out.write((const char *)data, num_bytes);
+        if (!out) {
+            fprintf(stderr, "Failed to write %s %s\n", what,
+                    tmp_path.c_str());
+            std::filesystem::remove(tmp_path, err);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path, err);
+    if (err) {
+        fprintf(stderr, "Failed to write %s %s: %s\n", what,
+                path.c_str(), err.message().c_str());
+        std::filesystem::remove(tmp_path, err);
+        return false;
+    }
+
+    return true;
+}
+
+bool assetCacheEnabled()
+{
+    const char *enable_str = getenv("MADRONA_ASSET_CACHE");
+    return !enable_str || enable_str[0] != '0';
+}
+
+std::filesystem::path assetCachePath(
+    const std::filesystem::path &default_dir,
+    const char *prefix,
+    uint64_t key)
+{
+    const char *dir_str = getenv("MADRONA_ASSET_CACHE_DIR");
+    std::filesystem::path dir = dir_str ? dir_str : default_dir;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s_%016llx.bin",
+             prefix, (unsigned long long)key);
+
+    return dir / name;
+}
+
+bool writeAssetCache(const std::filesystem::path &path,
+                     uint64_t key,
+                     Span<const AssetCacheSection> sections,
+                     Span<const std::string> dependencies,
+                     Span<const imp::SourceObject> objects,
+                     Span<const imp::SourceMaterial> materials,
+                     Span<const imp::SourceTexture> textures)
+{
+    BlobWriter writer;
+
+    std::vector<CacheRange> section_ranges;
+    section_ranges.reserve(sections.size());
+    for (const AssetCacheSection &section : sections) {
+        // Empty sections still need a non-null offset
+        uint64_t offset = section.numBytes > 0 ?
+            writer.append(section.data, section.numBytes) :
+            writer.append(&section, 0);
+        section_ranges.push_back({ offset, section.numBytes });
+    }
+
+    std::vector<CacheDependency> cache_deps;
+    cache_deps.reserve(dependencies.size());
+    for (const std::string &dep : dependencies) {
+        uint64_t offset = writer.append(dep.data(), dep.size(), 1);
+        cache_deps.push_back({
+            .path = { offset, dep.size() },
+            .stamp = hashFileStamp(dep, 0),
+        });
+    }
+
+    std::vector<CacheObject> cache_objs;
+    std::vector<CacheMesh> cache_meshes;
+    cache_objs.reserve(objects.size());
+    for (const imp::SourceObject &obj : objects) {
+        cache_objs.push_back({
+            .meshOffset = (uint32_t)cache_meshes.size(),
+            .numMeshes = (uint32_t)obj.meshes.size(),
+        });
+
+        for (const imp::SourceMesh &mesh : obj.meshes) {
+            uint64_t num_verts = mesh.numVertices;
+            uint64_t num_faces = mesh.numFaces;
+
+            cache_meshes.push_back({
+                .positions = writer.append(mesh.positions,
+                    sizeof(math::Vector3) * num_verts),
+                .normals = writer.append(mesh.normals,
+                    sizeof(math::Vector3) * num_verts),
+                .tangentAndSigns = writer.append(mesh.tangentAndSigns,
+                    sizeof(math::Vector4) * num_verts),
+                .uvs = writer.append(mesh.uvs,
+                    sizeof(math::Vector2) * num_verts),
+                .indices = writer.append(mesh.indices,
+                    sizeof(uint32_t) * numMeshIndices(mesh)),
+                .faceCounts = writer.append(mesh.faceCounts,
+                    sizeof(uint32_t) * num_faces),
+                .faceMaterials = writer.append(mesh.faceMaterials,
+                    sizeof(uint32_t) * num_faces),
+                .numVertices = mesh.numVertices,
+                .numFaces = mesh.numFaces,
+                .materialIDX = mesh.materialIDX,
+                .pad = 0,
+            });
+        }
+    }
+
+    std::vector<CacheTexture> cache_textures;
+    cache_textures.reserve(textures.size());
+    for (const imp::SourceTexture &tex : textures) {
+        uint64_t num_bytes = textureNumBytes(tex);
+        cache_textures.push_back({
+            .data = { writer.append(tex.data, num_bytes), num_bytes },
+            .format = (uint32_t)tex.format,
+            .width = tex.width,
+            .height = tex.height,
+            .pad = 0,
+        });
+    }
+
+    CacheHeader hdr {};
+    memcpy(hdr.magic, cacheMagic, sizeof(cacheMagic));
+    hdr.version = cacheVersion;
+    hdr.materialStride = sizeof(imp::SourceMaterial);
+    hdr.key = key;
+    hdr.numSections = (uint32_t)section_ranges.size();
+    hdr.numDependencies = (uint32_t)cache_deps.size();
+    hdr.numObjects = (uint32_t)cache_objs.size();
+    hdr.numMeshes = (uint32_t)cache_meshes.size();
+    hdr.numMaterials = (uint32_t)materials.size();
+    hdr.numTextures = (uint32_t)cache_textures.size();
+    hdr.sectionsOffset = writer.appendArray(section_ranges);
+    hdr.dependenciesOffset = writer.appendArray(cache_deps);
+    hdr.objectsOffset = writer.appendArray(cache_objs);
+    hdr.meshesOffset = writer.appendArray(cache_meshes);
+    hdr.materialsOffset = writer.append(materials.data(),
+        sizeof(imp::SourceMaterial) * materials.size());
+    hdr.texturesOffset = writer.appendArray(cache_textures);
+
+    std::vector<char> &buf = writer.buffer();
+    hdr.totalBytes = buf.size();
+    memcpy(buf.data(), &hdr, sizeof(CacheHeader));
+
+    return writeFileAtomic(path, buf.data(), buf.size(), "asset cache");
+}
+
+AssetCache::AssetCache(void *mapping, size_t num_mapped_bytes)
+    : mapping_(mapping),
+      numMappedBytes_(num_mapped_bytes),
+      sections_(),
+      meshes_(),
+      objects_(),
+      materials_(nullptr),
+      numMaterials_(0),
+      textures_()
+{}
+
+AssetCache::AssetCache(AssetCache &&o)
+    : mapping_(o.mapping_),
+      numMappedBytes_(o.numMappedBytes_),
+      sections_(std::move(o.sections_)),
+      meshes_(std::move(o.meshes_)),
+      objects_(std::move(o.objects_)),
+      materials_(o.materials_),
+      numMaterials_(o.numMaterials_),
+      textures_(std::move(o.textures_))
+{
+    o.mapping_ = nullptr;
+}
+
+AssetCache::~AssetCache()
+{
+    if (mapping_ != nullptr) {
+        munmap(mapping_, numMappedBytes_);
+    }
+}
+
+Optional<AssetCache> AssetCache::load(const std::filesystem::path &path,
+                                      uint64_t key)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return Optional<AssetCache>::none();
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) != 0 ||
+            (size_t)stat_buf.st_size < sizeof(CacheHeader)) {
+        close(fd);
+        return Optional<AssetCache>::none();
+    }
+
+    size_t num_bytes = (size_t)stat_buf.st_size;
+
+    // Private mapping: the importer types hold non-const pointers, and any
+    // writes through them must not reach the file.
+    void *mapping = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return Optional<AssetCache>::none();
+    }
+
+    AssetCache cache(mapping, num_bytes);
+    char *base = (char *)mapping;
+
+    const CacheHeader &hdr = *(const CacheHeader *)base;
+    if (memcmp(hdr.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+            hdr.version != cacheVersion ||
+            hdr.materialStride != sizeof(imp::SourceMaterial) ||
+            hdr.key != key ||
+            hdr.totalBytes != num_bytes ||
+            !rangeInBounds(hdr.sectionsOffset,
+                sizeof(CacheRange) * hdr.numSections, num_bytes) ||
+            !rangeInBounds(hdr.dependenciesOffset,
+                sizeof(CacheDependency) * hdr.numDependencies, num_bytes) ||
+            !rangeInBounds(hdr.objectsOffset,
+                sizeof(CacheObject) * hdr.numObjects, num_bytes) ||
+            !rangeInBounds(hdr.meshesOffset,
+                sizeof(CacheMesh) * hdr.numMeshes, num_bytes) ||
+            !rangeInBounds(hdr.materialsOffset,
+                sizeof(imp::SourceMaterial) * hdr.numMaterials, num_bytes) ||
+            !rangeInBounds(hdr.texturesOffset,
+                sizeof(CacheTexture) * hdr.numTextures, num_bytes)) {
+        fprintf(stderr, "Ignoring invalid asset cache %s\n", path.c_str());
+        return Optional<AssetCache>::none();
+    }
+
+    const CacheDependency *deps =
+        (const CacheDependency *)(base + hdr.dependenciesOffset);
+    for (uint32_t i = 0; i < hdr.numDependencies; i++) {
+        const CacheDependency &dep = deps[i];
+        if (!rangeInBounds(dep.path.offset, dep.path.numBytes, num_bytes)) {
+            return Optional<AssetCache>::none();
+        }
+
+        std::string dep_path(base + dep.path.offset, dep.path.numBytes);
+        if (hashFileStamp(dep_path, 0) != dep.stamp) {
+            printf("Asset cache %s is stale (%s changed)\n",
+                   path.c_str(), dep_path.c_str());
+            return Optional<AssetCache>::none();
+        }
+    }
+
+    const CacheRange *sections =
+        (const CacheRange *)(base + hdr.sectionsOffset);
+    cache.sections_.reserve(hdr.numSections);
+    for (uint32_t i = 0; i < hdr.numSections; i++) {
+        if (!rangeInBounds(sections[i].offset, sections[i].numBytes,
+                           num_bytes)) {
+            fprintf(stderr, "Ignoring invalid asset cache %s\n",
+                    path.c_str());
+            return Optional<AssetCache>::none();
+        }
+
+        cache.sections_.push_back({
+            .data = base + sections[i].offset,
+            .numBytes = sections[i].numBytes,
+        });
+    }
+
+    const CacheMesh *meshes = (const CacheMesh *)(base + hdr.meshesOffset);
+    cache.meshes_.reserve(hdr.numMeshes);
+    for (uint32_t i = 0; i < hdr.numMeshes; i++) {
+        const CacheMesh &mesh = meshes[i];
+        if (!meshInBounds(base, mesh, num_bytes)) {
+            fprintf(stderr, "Ignoring invalid asset cache %s\n",
+                    path.c_str());
+            return Optional<AssetCache>::none();
+        }
+
+        cache.meshes_.push_back({
+            .positions = mappedPtr<math::Vector3>(base, mesh.positions),
+            .normals = mappedPtr<math::Vector3>(base, mesh.normals),
+            .tangentAndSigns =
+                mappedPtr<math::Vector4>(base, mesh.tangentAndSigns),
+            .uvs = mappedPtr<math::Vector2>(base, mesh.uvs),
+            .indices = mappedPtr<uint32_t>(base, mesh.indices),
+            .faceCounts = mappedPtr<uint32_t>(base, mesh.faceCounts),
+            .faceMaterials = mappedPtr<uint32_t>(base, mesh.faceMaterials),
+            .numVertices = mesh.numVertices,
+            .numFaces = mesh.numFaces,
+            .materialIDX = mesh.materialIDX,
+        });
+    }
+
+    const CacheObject *objs = (const CacheObject *)(base + hdr.objectsOffset);
+    cache.objects_.reserve(hdr.numObjects);
+    for (uint32_t i = 0; i < hdr.numObjects; i++) {
+        if ((uint64_t)objs[i].meshOffset + objs[i].numMeshes >
+                hdr.numMeshes) {
+            fprintf(stderr, "Ignoring invalid asset cache %s\n",
+                    path.c_str());
+            return Optional<AssetCache>::none();
+        }
+
+        cache.objects_.push_back({
+            .meshes = Span<imp::SourceMesh>(
+                cache.meshes_.data() + objs[i].meshOffset,
+                objs[i].numMeshes),
+        });
+    }
+
+    cache.materials_ =
+        (const imp::SourceMaterial *)(base + hdr.materialsOffset);
+    cache.numMaterials_ = hdr.numMaterials;
+
+    const CacheTexture *textures =
+        (const CacheTexture *)(base + hdr.texturesOffset);
+    cache.textures_.reserve(hdr.numTextures);
+    for (uint32_t i = 0; i < hdr.numTextures; i++) {
+        const CacheTexture &tex = textures[i];
+        if (tex.data.offset != 0 && !rangeInBounds(
+                tex.data.offset, tex.data.numBytes, num_bytes)) {
+            fprintf(stderr, "Ignoring invalid asset cache %s\n",
+                    path.c_str());
+            return Optional<AssetCache>::none();
+        }
+
+        cache.textures_.push_back({
+            .data = mappedPtr<void>(base, tex.data.offset),
+            .format = (imp::SourceTextureFormat)tex.format,
+            .width = tex.width,
+            .height = tex.height,
+            .numBytes = tex.data.numBytes,
+        });
+    }
+
+    return Optional<AssetCache>(std::move(cache));
+}
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <madrona/importer.hpp>
+#include <madrona/optional.hpp>
+#include <madrona/span.hpp>
+
+namespace run {
+
+namespace imp = madrona::imp;
+
+// FNV-1a, used to build cache keys out of the inputs of a load.
+uint64_t hashBytes(const void *data, size_t num_bytes,
+                   uint64_t seed = 0xcbf29ce484222325);
+uint64_t hashString(std::string_view str, uint64_t seed);
+
+template <typename T>
+inline uint64_t hashValue(const T &v, uint64_t seed)
+{
+    return hashBytes(&v, sizeof(T), seed);
+}
+
+// Hashes the path, size and modification time of a file (not its
+// contents), which is enough to notice edited or replaced assets.
+uint64_t hashFileStamp(const std::filesystem::path &path, uint64_t seed);
+
+// Writes data to a temporary file and renames it to path, so concurrent
+// runs never map a partially written file. Failures are printed with what
+// naming the file's purpose.
+bool writeFileAtomic(const std::filesystem::path &path,
+                     const void *data, size_t num_bytes,
+                     const char *what);
+
+// Baked asset caches are used unless MADRONA_ASSET_CACHE=0. They are
+// stored in MADRONA_ASSET_CACHE_DIR if set, otherwise in default_dir.
+bool assetCacheEnabled();
+std::filesystem::path assetCachePath(
+    const std::filesystem::path &default_dir,
+    const char *prefix,
+    uint64_t key);
+
+// Opaque app-specific data (instance lists etc) stored next to the assets.
+struct AssetCacheSection {
+    const void *data;
+    uint64_t numBytes;
+};
+
+template <typename T>
+inline AssetCacheSection asCacheSection(const std::vector<T> &v)
+{
+    return AssetCacheSection {
+        .data = v.data(),
+        .numBytes = sizeof(T) * v.size(),
+    };
+}
+
+// Serializes everything needed to skip parsing and importing on the next
+// run. Files in dependencies are re-stat'ed on load, and the cache is
+// ignored if any of them changed. Returns false if the file couldn't be
+// written, which callers can treat as a warning.
+bool writeAssetCache(const std::filesystem::path &path,
+                     uint64_t key,
+                     madrona::Span<const AssetCacheSection> sections,
+                     madrona::Span<const std::string> dependencies,
+                     madrona::Span<const imp::SourceObject> objects,
+                     madrona::Span<const imp::SourceMaterial> materials,
+                     madrona::Span<const imp::SourceTexture> textures);
+
+// A baked cache file mapped into memory. Objects, meshes and textures
+// point directly into the mapping (copy-on-write), nothing is decoded.
+class AssetCache {
+public:
+    static madrona::Optional<AssetCache> load(
+        const std::filesystem::path &path, uint64_t key);
+
+    AssetCache(const AssetCache &) = delete;
+    AssetCache(AssetCache &&o);
+    ~AssetCache();
+
+    template <typename T>
+    std::vector<T> section(uint32_t idx) const;
+
+    inline madrona::Span<const imp::SourceObject> objects() const;
+    inline madrona::Span<const imp::SourceMaterial> materials() const;
+    inline madrona::Span<const imp::SourceTexture> textures() const;
+
+private:
+    AssetCache(void *mapping, size_t num_mapped_bytes);
+
+    void *mapping_;
+    size_t numMappedBytes_;
+    std::vector<AssetCacheSection> sections_;
+    std::vector<imp::SourceMesh> meshes_;
+    std::vector<imp::SourceObject> objects_;
+    const imp::SourceMaterial *materials_;
+    uint32_t numMaterials_;
+    std::vector<imp::SourceTexture> textures_;
+};
+
+// Render assets for a manager, either freshly imported or mapped from a
+// baked cache. Imported assets may come from several importers; the parts
+// own the memory and the imported* arrays are the merged view. Geometry
+// generated after import (merged scenes) is kept alive by extraStorage.
+struct LoadedAssets {
+    std::vector<imp::ImportedAssets> importedParts;
+    std::vector<std::shared_ptr<void>> extraStorage;
+    std::vector<imp::SourceObject> importedObjects;
+    std::vector<imp::SourceMaterial> importedMaterials;
+    std::vector<imp::SourceTexture> importedTextures;
+
+    madrona::Optional<AssetCache> cached;
+
+    inline madrona::Span<const imp::SourceObject> objects() const;
+    inline madrona::Span<const imp::SourceMaterial> materials() const;
+    inline madrona::Span<const imp::SourceTexture> textures() const;
+};
+
+}
+
+#include "asset_cache.inl"
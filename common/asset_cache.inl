@@ -0,0 +1,69 @@
+#include <cassert>
+#include <cstring>
+
+namespace run {
+
+template <typename T>
+std::vector<T> AssetCache::section(uint32_t idx) const
+{
+    assert(idx < sections_.size());
+    const AssetCacheSection &section = sections_[idx];
+    assert(section.numBytes % sizeof(T) == 0);
+
+    std::vector<T> out(section.numBytes / sizeof(T));
+    if (section.numBytes > 0) {
+        memcpy(out.data(), section.data, section.numBytes);
+    }
+
+    return out;
+}
+
+madrona::Span<const imp::SourceObject> AssetCache::objects() const
+{
+    return madrona::Span<const imp::SourceObject>(
+        objects_.data(), (madrona::CountT)objects_.size());
+}
+
+madrona::Span<const imp::SourceMaterial> AssetCache::materials() const
+{
+    return madrona::Span<const imp::SourceMaterial>(
+        materials_, (madrona::CountT)numMaterials_);
+}
+
+madrona::Span<const imp::SourceTexture> AssetCache::textures() const
+{
+    return madrona::Span<const imp::SourceTexture>(
+        textures_.data(), (madrona::CountT)textures_.size());
+}
+
+madrona::Span<const imp::SourceObject> LoadedAssets::objects() const
+{
+    if (cached.has_value()) {
+        return cached->objects();
+    }
+
+    return madrona::Span<const imp::SourceObject>(
+        importedObjects.data(), (madrona::CountT)importedObjects.size());
+}
+
+madrona::Span<const imp::SourceMaterial> LoadedAssets::materials() const
+{
+    if (cached.has_value()) {
+        return cached->materials();
+    }
+
+    return madrona::Span<const imp::SourceMaterial>(
+        importedMaterials.data(), (madrona::CountT)importedMaterials.size());
+}
+
+madrona::Span<const imp::SourceTexture> LoadedAssets::textures() const
+{
+    if (cached.has_value()) {
+        return cached->textures();
+    }
+
+    return madrona::Span<const imp::SourceTexture>(
+        importedTextures.data(), (madrona::CountT)importedTextures.size());
+}
+
+}
@@ -0,0 +1,123 @@
+#include "asset_import.hpp"
+#include "glb_decode.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+using namespace madrona;
+
+namespace run {
+
+bool importAssetsParallel(
+    Span<const std::string> paths,
+    uint32_t num_threads,
+    const std::function<void(imp::AssetImporter &)> &configure_importer,
+    const std::filesystem::path &cache_dir,
+    LoadedAssets &out,
+    Span<char> err_buf)
+{
+    const uint64_t num_paths = paths.size();
+
+    // A few chunks per thread, since GLB sizes vary wildly. Chunks are
+    // contiguous so merging them in order keeps objects in path order.
+    uint64_t num_chunks = std::min<uint64_t>(num_paths,
+        (uint64_t)std::max(num_threads, 1u) * 4);
+    num_chunks = std::max<uint64_t>(num_chunks, 1);
+    uint64_t paths_per_chunk = (num_paths + num_chunks - 1) / num_chunks;
+    if (paths_per_chunk > 0) {
+        num_chunks = (num_paths + paths_per_chunk - 1) / paths_per_chunk;
+    }
+
+    std::vector<Optional<imp::ImportedAssets>> chunk_assets;
+    chunk_assets.reserve(num_chunks);
+    for (uint64_t i = 0; i < num_chunks; i++) {
+        chunk_assets.push_back(Optional<imp::ImportedAssets>::none());
+    }
+
+    std::vector<std::array<char, 1024>> chunk_errs(num_chunks);
+
+    parallelFor(num_chunks, num_threads, [&](uint64_t chunk_idx) {
+        uint64_t chunk_start = chunk_idx * paths_per_chunk;
+        uint64_t chunk_end = std::min(chunk_start + paths_per_chunk,
+                                      num_paths);
+
+        std::vector<std::string> chunk_paths;
+        chunk_paths.reserve(chunk_end - chunk_start);
+        for (uint64_t i = chunk_start; i < chunk_end; i++) {
+            chunk_paths.push_back(decodedGLBPath(paths[i], cache_dir));
+        }
+
+        std::vector<const char *> chunk_cstrs;
+        chunk_cstrs.reserve(chunk_paths.size());
+        for (const std::string &path : chunk_paths) {
+            chunk_cstrs.push_back(path.c_str());
+        }
+
+        imp::AssetImporter importer;
+        if (configure_importer) {
+            configure_importer(importer);
+        }
+
+        std::array<char, 1024> &err = chunk_errs[chunk_idx];
+        err[0] = '\0';
+
+        chunk_assets[chunk_idx] = importer.importFromDisk(
+            chunk_cstrs, Span<char>(err.data(), err.size()), true);
+    });
+
+    out.importedParts.clear();
+    out.importedObjects.clear();
+    out.importedMaterials.clear();
+    out.importedTextures.clear();
+
+    for (uint64_t chunk_idx = 0; chunk_idx < num_chunks; chunk_idx++) {
+        Optional<imp::ImportedAssets> &assets = chunk_assets[chunk_idx];
+        if (!assets.has_value()) {
+            if (err_buf.size() > 0) {
+                snprintf(err_buf.data(), err_buf.size(), "%s",
+                         chunk_errs[chunk_idx].data());
+            }
+
+            return false;
+        }
+
+        out.importedParts.push_back(std::move(*assets));
+    }
+
+    // Merge after all parts have been moved into place, so the spans below
+    // point at their final storage.
+    for (imp::ImportedAssets &part : out.importedParts) {
+        uint32_t material_offset = (uint32_t)out.importedMaterials.size();
+        int32_t texture_offset = (int32_t)out.importedTextures.size();
+
+        for (const imp::SourceObject &obj : part.objects) {
+            for (imp::SourceMesh &mesh : obj.meshes) {
+                if (mesh.materialIDX != ~0u) {
+                    mesh.materialIDX += material_offset;
+                }
+            }
+
+            out.importedObjects.push_back(obj);
+        }
+
+        for (const imp::SourceMaterial &mat : part.materials) {
+            imp::SourceMaterial rebased = mat;
+            if (rebased.textureIdx >= 0) {
+                rebased.textureIdx += texture_offset;
+            }
+
+            out.importedMaterials.push_back(rebased);
+        }
+
+        for (const imp::SourceTexture &tex : part.textures) {
+            out.importedTextures.push_back(tex);
+        }
+    }
+
+    return true;
+}
+
+}
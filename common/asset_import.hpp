@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include <madrona/importer.hpp>
+#include <madrona/span.hpp>
+
+#include "asset_cache.hpp"
+
+namespace run {
+
+// Imports paths with several AssetImporters running in parallel, each on a
+// contiguous chunk of paths, and merges the results in path order with
+// material and texture indices rebased. Object i of the result is still
+// paths[i]. configure_importer is called on every importer before use, to
+// register image handlers etc., on the thread that then runs that
+// importer. Compressed GLBs are decoded by the same threads into cache_dir
+// first (see decodedGLBPath). Returns false and fills err_buf on failure.
+bool importAssetsParallel(
+    madrona::Span<const std::string> paths,
+    uint32_t num_threads,
+    const std::function<void(madrona::imp::AssetImporter &)> &
+        configure_importer,
+    const std::filesystem::path &cache_dir,
+    LoadedAssets &out,
+    madrona::Span<char> err_buf);
+
+}
@@ -0,0 +1,129 @@
+#include "camera_trajectory.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace run {
+
+namespace {
+
+// Must match scripts/gen_camera_trajectory.py
+constexpr uint32_t trajectoryVersion = 1;
+constexpr char trajectoryMagic[8] = { 'M', 'A', 'D', 'C', 'T', 'R', 'A', 'J' };
+
+// The poses follow the header
+struct TrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numTrajectories;
+    uint32_t numViews;
+    uint32_t numSteps;
+    uint64_t pad;
+};
+static_assert(sizeof(TrajectoryHeader) == 32);
+
+}
+
+CameraTrajectory::CameraTrajectory(void *mapping, size_t num_mapped_bytes)
+    : mapping_(mapping),
+      numMappedBytes_(num_mapped_bytes),
+      poses_(nullptr),
+      numTrajectories_(0),
+      numViews_(0),
+      numSteps_(0)
+{}
+
+CameraTrajectory::~CameraTrajectory()
+{
+    munmap(mapping_, numMappedBytes_);
+}
+
+size_t CameraTrajectory::numPoseBytes() const
+{
+    return numMappedBytes_ - sizeof(TrajectoryHeader);
+}
+
+std::unique_ptr<CameraTrajectory> CameraTrajectory::load(
+    const std::filesystem::path &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Failed to open camera trajectory %s\n",
+                path.c_str());
+        return nullptr;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) != 0 ||
+            (size_t)stat_buf.st_size < sizeof(TrajectoryHeader)) {
+        close(fd);
+        fprintf(stderr, "Camera trajectory %s is truncated\n", path.c_str());
+        return nullptr;
+    }
+
+    size_t num_bytes = (size_t)stat_buf.st_size;
+    void *mapping = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Failed to map camera trajectory %s\n", path.c_str());
+        return nullptr;
+    }
+
+    std::unique_ptr<CameraTrajectory> trajectory(
+        new CameraTrajectory(mapping, num_bytes));
+
+    const TrajectoryHeader &hdr = *(const TrajectoryHeader *)mapping;
+    uint64_t num_poses = (uint64_t)hdr.numTrajectories * hdr.numViews *
+        hdr.numSteps;
+
+    if (memcmp(hdr.magic, trajectoryMagic, sizeof(trajectoryMagic)) != 0 ||
+            hdr.version != trajectoryVersion ||
+            num_poses == 0 ||
+            num_poses * floatsPerPose * sizeof(float) !=
+                num_bytes - sizeof(TrajectoryHeader)) {
+        fprintf(stderr, "Invalid camera trajectory %s\n", path.c_str());
+        return nullptr;
+    }
+
+    trajectory->poses_ = (const float *)((const char *)mapping +
+        sizeof(TrajectoryHeader));
+    trajectory->numTrajectories_ = hdr.numTrajectories;
+    trajectory->numViews_ = hdr.numViews;
+    trajectory->numSteps_ = hdr.numSteps;
+
+    return trajectory;
+}
+
+std::unique_ptr<CameraTrajectory> cameraTrajectoryFromEnv(uint32_t num_views)
+{
+    const char *path = getenv("MADRONA_CAMERA_TRAJECTORY");
+    if (!path || path[0] == '\0') {
+        return nullptr;
+    }
+
+    std::unique_ptr<CameraTrajectory> trajectory =
+        CameraTrajectory::load(path);
+    if (!trajectory) {
+        exit(1);
+    }
+
+    if (trajectory->numViews() < num_views) {
+        fprintf(stderr, "Camera trajectory %s has %u views per world, "
+                "%u are needed\n", path, trajectory->numViews(), num_views);
+        exit(1);
+    }
+
+    printf("Replaying camera trajectory %s (%u trajectories, %u steps)\n",
+           path, trajectory->numTrajectories(), trajectory->numSteps());
+
+    return trajectory;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <filesystem>
+#include <memory>
+
+namespace run {
+
+// Precomputed camera poses for reproducible render benchmarks, written by
+// scripts/gen_camera_trajectory.py. The file holds numTrajectories
+// trajectories (world w replays trajectory w % numTrajectories), each with
+// numViews cameras and a pose per step for numSteps steps. Poses are
+// stored as floatsPerPose floats: position relative to the scene center
+// (x, y, z), then yaw and pitch in radians, laid out
+// [trajectory][view][step].
+//
+// The file is mapped read-only for the lifetime of the object.
+class CameraTrajectory {
+public:
+    static constexpr uint32_t floatsPerPose = 5;
+
+    // Prints why and returns null if the file is missing or invalid
+    static std::unique_ptr<CameraTrajectory> load(
+        const std::filesystem::path &path);
+
+    CameraTrajectory(const CameraTrajectory &) = delete;
+    ~CameraTrajectory();
+
+    uint32_t numTrajectories() const { return numTrajectories_; }
+    uint32_t numViews() const { return numViews_; }
+    uint32_t numSteps() const { return numSteps_; }
+
+    const float *poses() const { return poses_; }
+    size_t numPoseBytes() const;
+
+private:
+    CameraTrajectory(void *mapping, size_t num_mapped_bytes);
+
+    void *mapping_;
+    size_t numMappedBytes_;
+    const float *poses_;
+    uint32_t numTrajectories_;
+    uint32_t numViews_;
+    uint32_t numSteps_;
+};
+
+// Loads the trajectory MADRONA_CAMERA_TRAJECTORY points to, or returns null
+// if it isn't set. Exits if the file can't be used or has fewer than
+// num_views cameras per trajectory.
+std::unique_ptr<CameraTrajectory> cameraTrajectoryFromEnv(uint32_t num_views);
+
+}
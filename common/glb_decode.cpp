@@ -0,0 +1,996 @@
+#include "glb_decode.hpp"
+#include "asset_cache.hpp"
+#include "meshopt_codec.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+#include <simdjson.h>
+
+namespace run {
+
+namespace {
+
+// Bump when the rewritten output changes, to invalidate decoded copies
+constexpr uint64_t decodeVersion = 1;
+
+constexpr uint32_t glbMagic = 0x46546c67;
+constexpr uint32_t glbJSONChunk = 0x4e4f534a;
+constexpr uint32_t glbBINChunk = 0x004e4942;
+
+constexpr uint64_t componentFloat = 5126;
+
+struct GLBHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t length;
+};
+
+struct GLBChunkHeader {
+    uint32_t length;
+    uint32_t type;
+};
+
+struct BufferSource {
+    const uint8_t *data;
+    uint64_t numBytes;
+};
+
+struct ViewLayout {
+    uint64_t offset;
+    uint64_t numBytes;
+};
+
+// u' = m[0] * u + m[1] * v + m[2], v' = m[3] * u + m[4] * v + m[5]
+struct UVTransform {
+    float m[6];
+    uint64_t texCoord;
+};
+
+bool rangeInBounds(uint64_t offset, uint64_t num_bytes, uint64_t total)
+{
+    return offset <= total && num_bytes <= total - offset;
+}
+
+uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+simdjson::dom::parser & glbParser()
+{
+    static thread_local simdjson::dom::parser parser;
+    return parser;
+}
+
+// Cheap check on the raw JSON chunk, before paying for a parse
+bool mentionsCompression(std::string_view json)
+{
+    return json.find("EXT_meshopt_compression") != json.npos ||
+        json.find("KHR_mesh_quantization") != json.npos ||
+        json.find("KHR_draco_mesh_compression") != json.npos;
+}
+
+bool parseGLB(const uint8_t *data, size_t num_bytes,
+              std::string_view &json, BufferSource &bin)
+{
+    GLBHeader hdr;
+    GLBChunkHeader json_hdr;
+    if (num_bytes < sizeof(GLBHeader) + sizeof(GLBChunkHeader)) {
+        return false;
+    }
+
+    memcpy(&hdr, data, sizeof(GLBHeader));
+    memcpy(&json_hdr, data + sizeof(GLBHeader), sizeof(GLBChunkHeader));
+
+    uint64_t json_offset = sizeof(GLBHeader) + sizeof(GLBChunkHeader);
+    if (hdr.magic != glbMagic || hdr.version != 2 ||
+            json_hdr.type != glbJSONChunk ||
+            !rangeInBounds(json_offset, json_hdr.length, num_bytes)) {
+        return false;
+    }
+
+    json = std::string_view((const char *)data + json_offset,
+                            json_hdr.length);
+    bin = { nullptr, 0 };
+
+    uint64_t bin_hdr_offset = json_offset + json_hdr.length;
+    if (rangeInBounds(bin_hdr_offset, sizeof(GLBChunkHeader), num_bytes)) {
+        GLBChunkHeader bin_hdr;
+        memcpy(&bin_hdr, data + bin_hdr_offset, sizeof(GLBChunkHeader));
+
+        uint64_t bin_offset = bin_hdr_offset + sizeof(GLBChunkHeader);
+        if (bin_hdr.type == glbBINChunk &&
+                rangeInBounds(bin_offset, bin_hdr.length, num_bytes)) {
+            bin = { data + bin_offset, bin_hdr.length };
+        }
+    }
+
+    return true;
+}
+
+void writeJSONString(std::string &out, std::string_view str)
+{
+    out += '"';
+    for (char c : str) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default: {
+            if ((uint8_t)c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        } break;
+        }
+    }
+    out += '"';
+}
+
+void writeJSONNumber(std::string &out, double v)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", v);
+    out += buf;
+}
+
+// Serializes e, dropping object members named skip_key at any depth
+void writeJSON(std::string &out, simdjson::dom::element e,
+               std::string_view skip_key = {})
+{
+    using namespace simdjson;
+
+    switch (e.type()) {
+    case dom::element_type::ARRAY: {
+        out += '[';
+        bool first = true;
+        for (dom::element child : dom::array(e)) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            writeJSON(out, child, skip_key);
+        }
+        out += ']';
+    } break;
+    case dom::element_type::OBJECT: {
+        out += '{';
+        bool first = true;
+        for (dom::key_value_pair field : dom::object(e)) {
+            if (!skip_key.empty() && field.key == skip_key) {
+                continue;
+            }
+
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            writeJSONString(out, field.key);
+            out += ':';
+            writeJSON(out, field.value, skip_key);
+        }
+        out += '}';
+    } break;
+    case dom::element_type::INT64: {
+        out += std::to_string(int64_t(e));
+    } break;
+    case dom::element_type::UINT64: {
+        out += std::to_string(uint64_t(e));
+    } break;
+    case dom::element_type::DOUBLE: {
+        writeJSONNumber(out, double(e));
+    } break;
+    case dom::element_type::STRING: {
+        writeJSONString(out, std::string_view(e));
+    } break;
+    case dom::element_type::BOOL: {
+        out += bool(e) ? "true" : "false";
+    } break;
+    case dom::element_type::NULL_VALUE: {
+        out += "null";
+    } break;
+    }
+}
+
+// Writes members of an object one at a time, handling separators
+struct ObjectWriter {
+    std::string &out;
+    bool first = true;
+
+    explicit ObjectWriter(std::string &o)
+        : out(o)
+    {
+        out += '{';
+    }
+
+    std::string & key(std::string_view name)
+    {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+
+        writeJSONString(out, name);
+        out += ':';
+        return out;
+    }
+
+    void finish()
+    {
+        out += '}';
+    }
+};
+
+template <typename T>
+T getOr(simdjson::simdjson_result<simdjson::dom::element> e, T default_value)
+{
+    T v;
+    if (e.get(v)) {
+        return default_value;
+    }
+
+    return v;
+}
+
+uint64_t getUInt(simdjson::dom::element e, const char *key,
+                 uint64_t default_value)
+{
+    return getOr<uint64_t>(e[key], default_value);
+}
+
+std::vector<simdjson::dom::element> getArray(simdjson::dom::element root,
+                                             const char *key)
+{
+    std::vector<simdjson::dom::element> elems;
+
+    simdjson::dom::array arr;
+    if (!root[key].get(arr)) {
+        for (simdjson::dom::element e : arr) {
+            elems.push_back(e);
+        }
+    }
+
+    return elems;
+}
+
+uint32_t numComponents(std::string_view type)
+{
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    if (type == "MAT2") return 4;
+    if (type == "MAT3") return 9;
+    if (type == "MAT4") return 16;
+    return 0;
+}
+
+uint32_t componentBytes(uint64_t component_type)
+{
+    switch (component_type) {
+    case 5120: case 5121: return 1;
+    case 5122: case 5123: return 2;
+    case 5125: case 5126: return 4;
+    default: return 0;
+    }
+}
+
+float readComponent(const uint8_t *src, uint64_t component_type,
+                    bool normalized)
+{
+    switch (component_type) {
+    case 5120: {
+        int8_t v;
+        memcpy(&v, src, sizeof(v));
+        return normalized ? std::max(v / 127.f, -1.f) : (float)v;
+    }
+    case 5121: {
+        return normalized ? *src / 255.f : (float)*src;
+    }
+    case 5122: {
+        int16_t v;
+        memcpy(&v, src, sizeof(v));
+        return normalized ? std::max(v / 32767.f, -1.f) : (float)v;
+    }
+    case 5123: {
+        uint16_t v;
+        memcpy(&v, src, sizeof(v));
+        return normalized ? v / 65535.f : (float)v;
+    }
+    case 5125: {
+        uint32_t v;
+        memcpy(&v, src, sizeof(v));
+        return (float)v;
+    }
+    default: {
+        float v;
+        memcpy(&v, src, sizeof(v));
+        return v;
+    }
+    }
+}
+
+bool baseColorTransform(simdjson::dom::element material, UVTransform &out)
+{
+    simdjson::dom::element tex_info;
+    if (material.at_pointer("/pbrMetallicRoughness/baseColorTexture")
+            .get(tex_info)) {
+        return false;
+    }
+
+    simdjson::dom::element xform;
+    if (tex_info.at_pointer("/extensions/KHR_texture_transform").get(xform)) {
+        return false;
+    }
+
+    float offset[2] = { 0.f, 0.f };
+    float scale[2] = { 1.f, 1.f };
+    double rotation = getOr(xform["rotation"], 0.0);
+
+    simdjson::dom::array arr;
+    if (!xform["offset"].get(arr) && arr.size() == 2) {
+        offset[0] = (float)double(arr.at(0));
+        offset[1] = (float)double(arr.at(1));
+    }
+
+    if (!xform["scale"].get(arr) && arr.size() == 2) {
+        scale[0] = (float)double(arr.at(0));
+        scale[1] = (float)double(arr.at(1));
+    }
+
+    // translation * rotation * scale, as defined by KHR_texture_transform
+    float c = (float)cos(rotation);
+    float s = (float)sin(rotation);
+
+    out.m[0] = c * scale[0];
+    out.m[1] = s * scale[1];
+    out.m[2] = offset[0];
+    out.m[3] = -s * scale[0];
+    out.m[4] = c * scale[1];
+    out.m[5] = offset[1];
+
+    out.texCoord = getUInt(xform, "texCoord", getUInt(tex_info, "texCoord", 0));
+
+    return true;
+}
+
+bool isFloatAttribute(std::string_view name)
+{
+    return name == "POSITION" || name == "NORMAL" || name == "TANGENT" ||
+        name.starts_with("TEXCOORD_");
+}
+
+bool rewriteGLB(const void *data, size_t num_bytes,
+                std::vector<uint8_t> &out, std::string &err)
+{
+    using namespace simdjson;
+
+    std::string_view json;
+    BufferSource bin;
+    if (!parseGLB((const uint8_t *)data, num_bytes, json, bin) ||
+            !mentionsCompression(json)) {
+        return false;
+    }
+
+    auto fail = [&err](const char *msg) {
+        err = msg;
+        return false;
+    };
+
+    dom::element root;
+    if (glbParser().parse(json.data(), json.size()).get(root)) {
+        return fail("invalid JSON chunk");
+    }
+
+    bool has_meshopt = false;
+    bool has_quantization = false;
+    for (dom::element ext : getArray(root, "extensionsUsed")) {
+        std::string_view name;
+        if (ext.get(name)) {
+            continue;
+        }
+
+        if (name == "KHR_draco_mesh_compression") {
+            return fail("Draco compressed meshes aren't supported");
+        }
+
+        has_meshopt |= name == "EXT_meshopt_compression";
+        has_quantization |= name == "KHR_mesh_quantization";
+    }
+
+    if (!has_meshopt && !has_quantization) {
+        return false;
+    }
+
+    // The decoded copy lives elsewhere, so everything has to be embedded
+    for (dom::element image : getArray(root, "images")) {
+        std::string_view uri;
+        if (!image["uri"].get(uri) && !uri.starts_with("data:")) {
+            return fail("external images aren't supported");
+        }
+    }
+
+    // Meshopt fallback buffers have no data: every view into them is
+    // compressed, and decoded below.
+    std::vector<BufferSource> buffers;
+    for (dom::element buffer : getArray(root, "buffers")) {
+        bool fallback = getOr(buffer.at_pointer(
+            "/extensions/EXT_meshopt_compression/fallback"), false);
+
+        std::string_view uri;
+        if (fallback) {
+            buffers.push_back({ nullptr, 0 });
+        } else if (!buffer["uri"].get(uri)) {
+            return fail("external buffers aren't supported");
+        } else if (bin.data == nullptr) {
+            return fail("missing BIN chunk");
+        } else {
+            buffers.push_back(bin);
+        }
+    }
+
+    auto bufferRange = [&](uint64_t buffer_idx, uint64_t offset,
+                           uint64_t len) -> const uint8_t * {
+        if (buffer_idx >= buffers.size() ||
+                buffers[buffer_idx].data == nullptr ||
+                !rangeInBounds(offset, len, buffers[buffer_idx].numBytes)) {
+            return nullptr;
+        }
+
+        return buffers[buffer_idx].data + offset;
+    };
+
+    // Every view is rewritten into a single new BIN chunk, decoded or copied
+    std::vector<uint8_t> new_bin;
+    auto appendBin = [&new_bin](uint64_t len) {
+        uint64_t offset = alignOffset(new_bin.size(), 16);
+        new_bin.resize(offset + len);
+        return offset;
+    };
+
+    std::vector<dom::element> views = getArray(root, "bufferViews");
+    std::vector<ViewLayout> view_layouts;
+    view_layouts.reserve(views.size());
+
+    for (dom::element view : views) {
+        dom::element ext;
+        if (!view.at_pointer("/extensions/EXT_meshopt_compression")
+                .get(ext)) {
+            uint64_t stride = getUInt(ext, "byteStride", 0);
+            uint64_t count = getUInt(ext, "count", 0);
+            uint64_t src_len = getUInt(ext, "byteLength", 0);
+
+            const uint8_t *src = bufferRange(getUInt(ext, "buffer", ~0ull),
+                getUInt(ext, "byteOffset", 0), src_len);
+            if (src == nullptr) {
+                return fail("meshopt buffer view out of bounds");
+            }
+
+            std::string_view mode;
+            std::string_view filter_name =
+                getOr(ext["filter"], std::string_view("NONE"));
+            if (ext["mode"].get(mode)) {
+                return fail("meshopt buffer view without mode");
+            }
+
+            uint64_t offset = appendBin(count * stride);
+            uint8_t *dst = new_bin.data() + offset;
+
+            bool decoded;
+            if (mode == "ATTRIBUTES") {
+                MeshoptFilter filter = MeshoptFilter::None;
+                if (filter_name == "OCTAHEDRAL") {
+                    filter = MeshoptFilter::Octahedral;
+                } else if (filter_name == "QUATERNION") {
+                    filter = MeshoptFilter::Quaternion;
+                } else if (filter_name == "EXPONENTIAL") {
+                    filter = MeshoptFilter::Exponential;
+                }
+
+                decoded = decodeMeshoptVertexBuffer(
+                        dst, count, stride, src, src_len) &&
+                    applyMeshoptFilter(filter, dst, count, stride);
+            } else if (mode == "TRIANGLES") {
+                decoded = decodeMeshoptIndexBuffer(
+                    dst, count, stride, src, src_len);
+            } else if (mode == "INDICES") {
+                decoded = decodeMeshoptIndexSequence(
+                    dst, count, stride, src, src_len);
+            } else {
+                decoded = false;
+            }
+
+            if (!decoded) {
+                return fail("corrupt meshopt buffer view");
+            }
+
+            view_layouts.push_back({ offset, count * stride });
+        } else {
+            uint64_t len = getUInt(view, "byteLength", 0);
+            const uint8_t *src = bufferRange(getUInt(view, "buffer", ~0ull),
+                getUInt(view, "byteOffset", 0), len);
+            if (src == nullptr) {
+                return fail("buffer view out of bounds");
+            }
+
+            uint64_t offset = appendBin(len);
+            memcpy(new_bin.data() + offset, src, len);
+
+            view_layouts.push_back({ offset, len });
+        }
+    }
+
+    std::vector<dom::element> materials = getArray(root, "materials");
+    std::vector<int32_t> material_transforms(materials.size(), -1);
+    std::vector<UVTransform> uv_transforms;
+    for (size_t i = 0; i < materials.size(); i++) {
+        UVTransform xform;
+        if (baseColorTransform(materials[i], xform)) {
+            material_transforms[i] = (int32_t)uv_transforms.size();
+            uv_transforms.push_back(xform);
+        }
+    }
+
+    // Quantized (or texture transformed) attributes get new float
+    // accessors, appended after the existing ones, which are left as is.
+    std::vector<dom::element> accessors = getArray(root, "accessors");
+    std::vector<std::string> new_accessors;
+    std::unordered_map<uint64_t, uint64_t> float_accessors;
+
+    auto floatAccessor = [&](uint64_t accessor_idx, bool is_position,
+                             int32_t xform_idx, uint64_t &result) {
+        uint64_t memo_key =
+            accessor_idx * (uv_transforms.size() + 1) + (xform_idx + 1);
+        auto iter = float_accessors.find(memo_key);
+        if (iter != float_accessors.end()) {
+            result = iter->second;
+            return true;
+        }
+
+        if (accessor_idx >= accessors.size()) {
+            return false;
+        }
+
+        dom::element accessor = accessors[accessor_idx];
+
+        dom::element sparse;
+        std::string_view type;
+        uint64_t view_idx;
+        if (!accessor["sparse"].get(sparse) || accessor["type"].get(type) ||
+                accessor["bufferView"].get(view_idx) ||
+                view_idx >= view_layouts.size()) {
+            return false;
+        }
+
+        uint64_t component_type = getUInt(accessor, "componentType", 0);
+        uint64_t count = getUInt(accessor, "count", 0);
+        uint64_t byte_offset = getUInt(accessor, "byteOffset", 0);
+        bool normalized = getOr(accessor["normalized"], false);
+
+        uint32_t num_comps = numComponents(type);
+        uint32_t comp_bytes = componentBytes(component_type);
+        if (num_comps == 0 || comp_bytes == 0) {
+            return false;
+        }
+
+        uint64_t elem_bytes = (uint64_t)num_comps * comp_bytes;
+        uint64_t stride = getUInt(views[view_idx], "byteStride", elem_bytes);
+
+        const ViewLayout &layout = view_layouts[view_idx];
+        if (count > 0 && !rangeInBounds(byte_offset,
+                (count - 1) * stride + elem_bytes, layout.numBytes)) {
+            return false;
+        }
+
+        std::vector<float> values(count * num_comps);
+        const uint8_t *src = new_bin.data() + layout.offset + byte_offset;
+        for (uint64_t i = 0; i < count; i++) {
+            for (uint32_t c = 0; c < num_comps; c++) {
+                values[i * num_comps + c] = readComponent(
+                    src + i * stride + c * comp_bytes,
+                    component_type, normalized);
+            }
+        }
+
+        if (xform_idx >= 0 && num_comps >= 2) {
+            const float *m = uv_transforms[xform_idx].m;
+            for (uint64_t i = 0; i < count; i++) {
+                float *uv = &values[i * num_comps];
+                float u = uv[0], v = uv[1];
+                uv[0] = m[0] * u + m[1] * v + m[2];
+                uv[1] = m[3] * u + m[4] * v + m[5];
+            }
+        }
+
+        uint64_t num_bytes = sizeof(float) * values.size();
+        uint64_t offset = appendBin(num_bytes);
+        memcpy(new_bin.data() + offset, values.data(), num_bytes);
+
+        uint64_t new_view_idx = view_layouts.size();
+        view_layouts.push_back({ offset, num_bytes });
+
+        std::string accessor_json;
+        ObjectWriter obj(accessor_json);
+        obj.key("bufferView") += std::to_string(new_view_idx);
+        obj.key("componentType") += std::to_string(componentFloat);
+        obj.key("count") += std::to_string(count);
+        writeJSONString(obj.key("type"), type);
+
+        // Positions are required to have bounds
+        if (is_position && count > 0) {
+            std::vector<float> min(values.begin(), values.begin() + num_comps);
+            std::vector<float> max = min;
+            for (uint64_t i = 1; i < count; i++) {
+                for (uint32_t c = 0; c < num_comps; c++) {
+                    float v = values[i * num_comps + c];
+                    min[c] = std::min(min[c], v);
+                    max[c] = std::max(max[c], v);
+                }
+            }
+
+            for (const auto &[name, bound] :
+                    { std::pair { "min", &min }, std::pair { "max", &max } }) {
+                std::string &dst = obj.key(name);
+                dst += '[';
+                for (uint32_t c = 0; c < num_comps; c++) {
+                    if (c > 0) {
+                        dst += ',';
+                    }
+                    writeJSONNumber(dst, (*bound)[c]);
+                }
+                dst += ']';
+            }
+        }
+        obj.finish();
+
+        result = accessors.size() + new_accessors.size();
+        new_accessors.push_back(std::move(accessor_json));
+        float_accessors.emplace(memo_key, result);
+        return true;
+    };
+
+    // Attribute remapping per mesh and primitive
+    using AttributeRemap = std::unordered_map<std::string_view, uint64_t>;
+    std::vector<dom::element> meshes = getArray(root, "meshes");
+    std::vector<std::vector<AttributeRemap>> mesh_remaps(meshes.size());
+
+    for (size_t mesh_idx = 0; mesh_idx < meshes.size(); mesh_idx++) {
+        for (dom::element prim : getArray(meshes[mesh_idx], "primitives")) {
+            AttributeRemap &remap = mesh_remaps[mesh_idx].emplace_back();
+
+            uint64_t material_idx = getUInt(prim, "material", ~0ull);
+            int32_t xform_idx = material_idx < materials.size() ?
+                material_transforms[material_idx] : -1;
+
+            dom::object attrs;
+            if (prim["attributes"].get(attrs)) {
+                continue;
+            }
+
+            for (dom::key_value_pair attr : attrs) {
+                uint64_t accessor_idx;
+                if (!isFloatAttribute(attr.key) ||
+                        attr.value.get(accessor_idx) ||
+                        accessor_idx >= accessors.size()) {
+                    continue;
+                }
+
+                bool is_uv = attr.key.starts_with("TEXCOORD_");
+                int32_t attr_xform = -1;
+                if (is_uv && xform_idx >= 0 &&
+                        attr.key.substr(9) == std::to_string(
+                            uv_transforms[xform_idx].texCoord)) {
+                    attr_xform = xform_idx;
+                }
+
+                if (getUInt(accessors[accessor_idx], "componentType", 0) ==
+                        componentFloat && attr_xform < 0) {
+                    continue;
+                }
+
+                uint64_t new_idx;
+                if (!floatAccessor(accessor_idx, attr.key == "POSITION",
+                                   attr_xform, new_idx)) {
+                    return fail("unsupported quantized attribute");
+                }
+
+                remap.emplace(attr.key, new_idx);
+            }
+        }
+    }
+
+    std::string new_json;
+    ObjectWriter root_obj(new_json);
+
+    for (dom::key_value_pair field : dom::object(root)) {
+        std::string_view key = field.key;
+
+        if (key == "buffers") {
+            if (new_bin.empty()) {
+                continue;
+            }
+
+            root_obj.key(key) += "[{\"byteLength\":" +
+                std::to_string(new_bin.size()) + "}]";
+        } else if (key == "bufferViews") {
+            std::string &dst = root_obj.key(key);
+            dst += '[';
+            for (size_t i = 0; i < view_layouts.size(); i++) {
+                if (i > 0) {
+                    dst += ',';
+                }
+
+                ObjectWriter view_obj(dst);
+                if (i < views.size()) {
+                    for (dom::key_value_pair view_field :
+                            dom::object(views[i])) {
+                        std::string_view view_key = view_field.key;
+                        if (view_key == "buffer" ||
+                                view_key == "byteOffset" ||
+                                view_key == "byteLength") {
+                            continue;
+                        }
+
+                        if (view_key == "extensions") {
+                            dom::object exts = view_field.value;
+                            dom::element unused;
+                            if (exts.size() == 1 &&
+                                    !exts["EXT_meshopt_compression"]
+                                        .get(unused)) {
+                                continue;
+                            }
+                        }
+
+                        writeJSON(view_obj.key(view_key), view_field.value,
+                                  "EXT_meshopt_compression");
+                    }
+                }
+
+                view_obj.key("buffer") += '0';
+                view_obj.key("byteOffset") +=
+                    std::to_string(view_layouts[i].offset);
+                view_obj.key("byteLength") +=
+                    std::to_string(view_layouts[i].numBytes);
+                view_obj.finish();
+            }
+            dst += ']';
+        } else if (key == "accessors") {
+            std::string &dst = root_obj.key(key);
+            dst += '[';
+            for (size_t i = 0; i < accessors.size(); i++) {
+                if (i > 0) {
+                    dst += ',';
+                }
+                writeJSON(dst, accessors[i]);
+            }
+            for (const std::string &accessor : new_accessors) {
+                dst += ',';
+                dst += accessor;
+            }
+            dst += ']';
+        } else if (key == "meshes") {
+            std::string &dst = root_obj.key(key);
+            dst += '[';
+            for (size_t mesh_idx = 0; mesh_idx < meshes.size(); mesh_idx++) {
+                if (mesh_idx > 0) {
+                    dst += ',';
+                }
+
+                ObjectWriter mesh_obj(dst);
+                for (dom::key_value_pair mesh_field :
+                        dom::object(meshes[mesh_idx])) {
+                    if (mesh_field.key != "primitives") {
+                        writeJSON(mesh_obj.key(mesh_field.key),
+                                  mesh_field.value);
+                        continue;
+                    }
+
+                    std::string &prims_dst = mesh_obj.key("primitives");
+                    prims_dst += '[';
+                    size_t prim_idx = 0;
+                    for (dom::element prim : dom::array(mesh_field.value)) {
+                        if (prim_idx > 0) {
+                            prims_dst += ',';
+                        }
+
+                        const AttributeRemap &remap =
+                            mesh_remaps[mesh_idx][prim_idx++];
+
+                        ObjectWriter prim_obj(prims_dst);
+                        for (dom::key_value_pair prim_field :
+                                dom::object(prim)) {
+                            if (prim_field.key != "attributes") {
+                                writeJSON(prim_obj.key(prim_field.key),
+                                          prim_field.value);
+                                continue;
+                            }
+
+                            ObjectWriter attrs_obj(
+                                prim_obj.key("attributes"));
+                            for (dom::key_value_pair attr :
+                                    dom::object(prim_field.value)) {
+                                auto iter = remap.find(attr.key);
+                                if (iter != remap.end()) {
+                                    attrs_obj.key(attr.key) +=
+                                        std::to_string(iter->second);
+                                } else {
+                                    writeJSON(attrs_obj.key(attr.key),
+                                              attr.value);
+                                }
+                            }
+                            attrs_obj.finish();
+                        }
+                        prim_obj.finish();
+                    }
+                    prims_dst += ']';
+                }
+                mesh_obj.finish();
+            }
+            dst += ']';
+        } else if (key == "materials") {
+            // Transforms baked into texcoords must not be applied again
+            std::string &dst = root_obj.key(key);
+            dst += '[';
+            for (size_t i = 0; i < materials.size(); i++) {
+                if (i > 0) {
+                    dst += ',';
+                }
+                writeJSON(dst, materials[i], material_transforms[i] >= 0 ?
+                    "KHR_texture_transform" : "");
+            }
+            dst += ']';
+        } else if (key == "extensionsUsed" || key == "extensionsRequired") {
+            std::vector<std::string_view> exts;
+            for (dom::element ext : dom::array(field.value)) {
+                std::string_view name;
+                if (ext.get(name) || name == "EXT_meshopt_compression" ||
+                        name == "KHR_mesh_quantization" ||
+                        (key == "extensionsRequired" &&
+                         name == "KHR_texture_transform")) {
+                    continue;
+                }
+
+                exts.push_back(name);
+            }
+
+            if (exts.empty()) {
+                continue;
+            }
+
+            std::string &dst = root_obj.key(key);
+            dst += '[';
+            for (size_t i = 0; i < exts.size(); i++) {
+                if (i > 0) {
+                    dst += ',';
+                }
+                writeJSONString(dst, exts[i]);
+            }
+            dst += ']';
+        } else {
+            writeJSON(root_obj.key(key), field.value);
+        }
+    }
+    root_obj.finish();
+
+    // Chunks are 4 byte aligned: JSON padded with spaces, BIN with zeros
+    new_json.resize(alignOffset(new_json.size(), 4), ' ');
+    new_bin.resize(alignOffset(new_bin.size(), 4), 0);
+
+    uint64_t total_bytes = sizeof(GLBHeader) +
+        sizeof(GLBChunkHeader) + new_json.size();
+    if (!new_bin.empty()) {
+        total_bytes += sizeof(GLBChunkHeader) + new_bin.size();
+    }
+
+    if (total_bytes > UINT32_MAX) {
+        return fail("decoded GLB exceeds 4GB");
+    }
+
+    out.clear();
+    out.reserve(total_bytes);
+
+    auto append = [&out](const void *src, size_t len) {
+        out.insert(out.end(), (const uint8_t *)src,
+                   (const uint8_t *)src + len);
+    };
+
+    GLBHeader hdr { glbMagic, 2, (uint32_t)total_bytes };
+    GLBChunkHeader json_hdr { (uint32_t)new_json.size(), glbJSONChunk };
+    append(&hdr, sizeof(hdr));
+    append(&json_hdr, sizeof(json_hdr));
+    append(new_json.data(), new_json.size());
+
+    if (!new_bin.empty()) {
+        GLBChunkHeader bin_hdr { (uint32_t)new_bin.size(), glbBINChunk };
+        append(&bin_hdr, sizeof(bin_hdr));
+        append(new_bin.data(), new_bin.size());
+    }
+
+    return true;
+}
+
+}
+
+bool decodeCompressedGLB(const void *data, size_t num_bytes,
+                         std::vector<uint8_t> &out, std::string &err)
+{
+    // Elements of unexpected types throw while rewriting
+    try {
+        return rewriteGLB(data, num_bytes, out, err);
+    } catch (const simdjson::simdjson_error &e) {
+        err = e.what();
+        return false;
+    }
+}
+
+std::string decodedGLBPath(const std::string &path,
+                           const std::filesystem::path &cache_dir)
+{
+    std::filesystem::path src_path(path);
+    if (src_path.extension() != ".glb") {
+        return path;
+    }
+
+    // Only the JSON chunk is read to tell whether the GLB is compressed
+    std::ifstream in(path, std::ios::binary);
+
+    GLBHeader hdr;
+    GLBChunkHeader json_hdr;
+    if (!in.read((char *)&hdr, sizeof(hdr)) ||
+            !in.read((char *)&json_hdr, sizeof(json_hdr)) ||
+            hdr.magic != glbMagic || json_hdr.type != glbJSONChunk ||
+            json_hdr.length > hdr.length) {
+        return path;
+    }
+
+    std::string json(json_hdr.length, '\0');
+    if (!in.read(json.data(), json.size()) || !mentionsCompression(json)) {
+        return path;
+    }
+
+    uint64_t key = hashFileStamp(src_path, hashValue(decodeVersion, 0));
+    std::filesystem::path decoded_path =
+        assetCachePath(cache_dir, "decoded", key);
+    decoded_path.replace_extension(".glb");
+
+    std::error_code err;
+    if (std::filesystem::exists(decoded_path, err)) {
+        return decoded_path.string();
+    }
+
+    std::vector<uint8_t> src(hdr.length);
+    in.seekg(0);
+    if (!in.read((char *)src.data(), src.size())) {
+        return path;
+    }
+
+    std::vector<uint8_t> decoded;
+    std::string decode_err;
+    if (!decodeCompressedGLB(src.data(), src.size(), decoded, decode_err)) {
+        if (!decode_err.empty()) {
+            fprintf(stderr, "Importing %s as is: %s\n",
+                    path.c_str(), decode_err.c_str());
+        }
+
+        return path;
+    }
+
+    if (!writeFileAtomic(decoded_path, decoded.data(), decoded.size(),
+                         "decoded GLB")) {
+        return path;
+    }
+
+    return decoded_path.string();
+}
+
+}
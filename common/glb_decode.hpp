@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace run {
+
+// Rewrites a GLB compressed with gltfpack-style extensions into one
+// madrona's glTF importer can read: EXT_meshopt_compression buffer views
+// are decoded, and KHR_mesh_quantization vertex attributes (positions,
+// normals, tangents, texcoords) are converted to floats, with base color
+// KHR_texture_transforms baked into the texcoords they apply to. Returns
+// false, leaving out untouched, if the GLB uses neither extension, or if it
+// can't be rewritten (Draco, external buffers or images, malformed data),
+// in which case err says why.
+bool decodeCompressedGLB(const void *data, size_t num_bytes,
+                         std::vector<uint8_t> &out, std::string &err);
+
+// Path to import in place of path: a decoded copy of path in cache_dir
+// (or MADRONA_ASSET_CACHE_DIR) if it is a compressed GLB, otherwise path
+// itself. Copies are keyed by the source's stamp and reused across runs.
+std::string decodedGLBPath(const std::string &path,
+                           const std::filesystem::path &cache_dir);
+
+}
@@ -0,0 +1,175 @@
+#include "ktx_import.hpp"
+#include "asset_cache.hpp"
+#include "ktx_trim.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace madrona;
+
+namespace run {
+
+namespace {
+
+// Bump when the transcoder output or the layout below changes.
+constexpr uint32_t transcodeVersion = 1;
+constexpr char transcodeMagic[8] = { 'M', 'A', 'D', 'B', 'C', '7', 'T', 'X' };
+
+// The payload follows the header at a fixed, block aligned offset
+struct TranscodeHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint64_t key;
+    uint32_t height;
+    uint32_t pad;
+    uint64_t numBytes;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(TranscodeHeader) == 64);
+
+// KTX2 sources are megabytes each, so they are hashed a word at a time
+// rather than with the byte-wise hashBytes.
+uint64_t hashPayload(const void *data, size_t num_bytes, uint64_t seed)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    size_t num_words = num_bytes / sizeof(uint64_t);
+
+    uint64_t hash = hashValue((uint64_t)num_bytes, seed);
+    for (size_t i = 0; i < num_words; i++) {
+        uint64_t word;
+        memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+
+        hash ^= word;
+        hash *= 0x100000001b3;
+        hash ^= hash >> 32;
+    }
+
+    return hashBytes(bytes + num_words * sizeof(uint64_t),
+                     num_bytes % sizeof(uint64_t), hash);
+}
+
+bool loadTranscoded(const std::filesystem::path &path, uint64_t key,
+                    TranscodedTexture &out)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) != 0 ||
+            (size_t)stat_buf.st_size < sizeof(TranscodeHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t num_bytes = (size_t)stat_buf.st_size;
+
+    // Private mapping: SourceTexture::data isn't const
+    void *mapping = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const TranscodeHeader &hdr = *(const TranscodeHeader *)mapping;
+    if (memcmp(hdr.magic, transcodeMagic, sizeof(transcodeMagic)) != 0 ||
+            hdr.version != transcodeVersion || hdr.key != key ||
+            hdr.numBytes != num_bytes - sizeof(TranscodeHeader)) {
+        munmap(mapping, num_bytes);
+        return false;
+    }
+
+    out = TranscodedTexture {
+        .data = (char *)mapping + sizeof(TranscodeHeader),
+        .width = hdr.width,
+        .height = hdr.height,
+        .numBytes = hdr.numBytes,
+    };
+
+    return true;
+}
+
+void storeTranscoded(const std::filesystem::path &path, uint64_t key,
+                     const TranscodedTexture &tex)
+{
+    TranscodeHeader hdr {};
+    memcpy(hdr.magic, transcodeMagic, sizeof(transcodeMagic));
+    hdr.version = transcodeVersion;
+    hdr.width = tex.width;
+    hdr.height = tex.height;
+    hdr.key = key;
+    hdr.numBytes = tex.numBytes;
+
+    std::vector<char> buf(sizeof(TranscodeHeader) + tex.numBytes);
+    memcpy(buf.data(), &hdr, sizeof(TranscodeHeader));
+    memcpy(buf.data() + sizeof(TranscodeHeader), tex.data, tex.numBytes);
+
+    // A failed write only costs transcoding again next time
+    writeFileAtomic(path, buf.data(), buf.size(), "transcoded texture");
+}
+
+imp::SourceTexture toSourceTexture(const TranscodedTexture &tex)
+{
+    return imp::SourceTexture {
+        .data = tex.data,
+        .format = imp::SourceTextureFormat::BC7,
+        .width = tex.width,
+        .height = tex.height,
+        .numBytes = tex.numBytes,
+    };
+}
+
+}
+
+Optional<imp::SourceTexture> importKTX2Texture(
+    const void *data, size_t num_bytes,
+    uint32_t max_dim,
+    const std::filesystem::path &cache_dir,
+    KTX2TranscodeFn transcode)
+{
+    bool use_cache = assetCacheEnabled();
+
+    uint64_t key = 0;
+    std::filesystem::path cache_path;
+    if (use_cache) {
+        key = hashValue(transcodeVersion, 0);
+        key = hashValue(max_dim, key);
+        key = hashPayload(data, num_bytes, key);
+
+        cache_path = assetCachePath(cache_dir, "bc7", key);
+
+        TranscodedTexture cached;
+        if (loadTranscoded(cache_path, key, cached)) {
+            return toSourceTexture(cached);
+        }
+    }
+
+    // Drop mip levels the batch renderer can't resolve before transcoding
+    std::vector<uint8_t> trimmed;
+    if (trimKTX2MipLevels(data, num_bytes, max_dim, trimmed)) {
+        data = trimmed.data();
+        num_bytes = trimmed.size();
+    }
+
+    TranscodedTexture transcoded;
+    if (!transcode(data, num_bytes, transcoded)) {
+        return Optional<imp::SourceTexture>::none();
+    }
+
+    if (use_cache) {
+        storeTranscoded(cache_path, key, transcoded);
+    }
+
+    return toSourceTexture(transcoded);
+}
+
+}
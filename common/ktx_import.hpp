@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <filesystem>
+
+#include <madrona/importer.hpp>
+#include <madrona/optional.hpp>
+
+namespace run {
+
+namespace imp = madrona::imp;
+
+struct TranscodedTexture {
+    void *data;
+    uint32_t width;
+    uint32_t height;
+    uint64_t numBytes;
+};
+
+// Transcodes a KTX2 container to BC7. Returns false on failure.
+using KTX2TranscodeFn = bool (*)(const void *data, size_t num_bytes,
+                                 TranscodedTexture &out);
+
+// Imports a KTX2 texture as BC7, dropping mip levels above max_dim
+// (trimKTX2MipLevels) before calling transcode. Results are cached in
+// cache_dir (or MADRONA_ASSET_CACHE_DIR) keyed by a hash of the source
+// bytes and max_dim, and later imports of the same texture map the cached
+// payload instead of transcoding. Mappings, like transcoder allocations,
+// are never released. MADRONA_ASSET_CACHE=0 disables the cache.
+madrona::Optional<imp::SourceTexture> importKTX2Texture(
+    const void *data, size_t num_bytes,
+    uint32_t max_dim,
+    const std::filesystem::path &cache_dir,
+    KTX2TranscodeFn transcode);
+
+}
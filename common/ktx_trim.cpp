@@ -0,0 +1,236 @@
+#include "ktx_trim.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace run {
+
+namespace {
+
+constexpr uint8_t ktx2Identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n',
+};
+
+struct KTX2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(KTX2Header) == 80);
+
+struct KTX2Level {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+// BasisLZ global data: header, one image descriptor per image of every
+// level (largest level first), then codebooks shared by all levels.
+struct BasisLZGlobalHeader {
+    uint16_t endpointCount;
+    uint16_t selectorCount;
+    uint32_t endpointsByteLength;
+    uint32_t selectorsByteLength;
+    uint32_t tablesByteLength;
+    uint32_t extendedByteLength;
+};
+static_assert(sizeof(BasisLZGlobalHeader) == 20);
+
+constexpr uint32_t basisLZImageDescBytes = 20;
+
+constexpr uint32_t supercompressionNone = 0;
+constexpr uint32_t supercompressionBasisLZ = 1;
+
+bool inBounds(uint64_t offset, uint64_t num_bytes, uint64_t total)
+{
+    return offset <= total && num_bytes <= total - offset;
+}
+
+uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+}
+
+uint32_t maxTextureDimForView(uint32_t view_width, uint32_t view_height)
+{
+    const char *dim_str = getenv("MADRONA_TEXTURE_DIM");
+    if (dim_str) {
+        return (uint32_t)std::stoi(dim_str);
+    }
+
+    // Surfaces close to the camera can still magnify a texture, so keep a
+    // few texels per pixel.
+    constexpr uint32_t texelsPerPixel = 4;
+
+    uint32_t target = std::max(view_width, view_height) * texelsPerPixel;
+    uint32_t dim = 1;
+    while (dim < target) {
+        dim *= 2;
+    }
+
+    return dim;
+}
+
+bool trimKTX2MipLevels(const void *data, size_t num_bytes,
+                       uint32_t max_dim, std::vector<uint8_t> &out)
+{
+    const uint8_t *src = (const uint8_t *)data;
+
+    if (max_dim == 0 || num_bytes < sizeof(KTX2Header) ||
+            memcmp(src, ktx2Identifier, sizeof(ktx2Identifier)) != 0) {
+        return false;
+    }
+
+    KTX2Header hdr;
+    memcpy(&hdr, src, sizeof(KTX2Header));
+
+    // Raw formats would need their block size for level alignment; only
+    // the Basis Universal payloads HSSD ships (vkFormat undefined) are
+    // handled.
+    if (hdr.levelCount <= 1 || hdr.pixelDepth > 1 ||
+            (hdr.supercompressionScheme == supercompressionNone &&
+             hdr.vkFormat != 0)) {
+        return false;
+    }
+
+    uint32_t num_skip = 0;
+    while (num_skip + 1 < hdr.levelCount &&
+           std::max(hdr.pixelWidth >> num_skip,
+                    hdr.pixelHeight >> num_skip) > max_dim) {
+        num_skip++;
+    }
+
+    if (num_skip == 0) {
+        return false;
+    }
+
+    uint64_t levels_offset = sizeof(KTX2Header);
+    if (!inBounds(levels_offset, sizeof(KTX2Level) * hdr.levelCount,
+                  num_bytes) ||
+            !inBounds(hdr.dfdByteOffset, hdr.dfdByteLength, num_bytes) ||
+            !inBounds(hdr.kvdByteOffset, hdr.kvdByteLength, num_bytes) ||
+            !inBounds(hdr.sgdByteOffset, hdr.sgdByteLength, num_bytes)) {
+        return false;
+    }
+
+    std::vector<KTX2Level> levels(hdr.levelCount);
+    memcpy(levels.data(), src + levels_offset,
+           sizeof(KTX2Level) * hdr.levelCount);
+
+    for (const KTX2Level &level : levels) {
+        if (!inBounds(level.byteOffset, level.byteLength, num_bytes)) {
+            return false;
+        }
+    }
+
+    uint32_t new_num_levels = hdr.levelCount - num_skip;
+    uint32_t images_per_level =
+        std::max(hdr.layerCount, 1u) * std::max(hdr.faceCount, 1u);
+
+    // BasisLZ keeps per-image slice descriptors in the global data, which
+    // have to lose the dropped levels too.
+    std::vector<uint8_t> sgd(src + hdr.sgdByteOffset,
+                             src + hdr.sgdByteOffset + hdr.sgdByteLength);
+    if (hdr.supercompressionScheme == supercompressionBasisLZ) {
+        uint64_t descs_bytes = (uint64_t)basisLZImageDescBytes *
+            images_per_level * hdr.levelCount;
+        if (sgd.size() < sizeof(BasisLZGlobalHeader) + descs_bytes) {
+            return false;
+        }
+
+        auto skip_begin = sgd.begin() + sizeof(BasisLZGlobalHeader);
+        sgd.erase(skip_begin, skip_begin +
+            (uint64_t)basisLZImageDescBytes * images_per_level * num_skip);
+    }
+
+    uint64_t level_alignment =
+        hdr.supercompressionScheme == supercompressionNone ? 16 : 1;
+
+    uint64_t cur_offset = sizeof(KTX2Header) +
+        sizeof(KTX2Level) * new_num_levels;
+
+    KTX2Header new_hdr = hdr;
+    new_hdr.pixelWidth = std::max(hdr.pixelWidth >> num_skip, 1u);
+    new_hdr.pixelHeight = hdr.pixelHeight == 0 ? 0 :
+        std::max(hdr.pixelHeight >> num_skip, 1u);
+    new_hdr.levelCount = new_num_levels;
+
+    cur_offset = alignOffset(cur_offset, 4);
+    new_hdr.dfdByteOffset = hdr.dfdByteLength > 0 ? (uint32_t)cur_offset : 0;
+    cur_offset += hdr.dfdByteLength;
+
+    cur_offset = alignOffset(cur_offset, 4);
+    new_hdr.kvdByteOffset = hdr.kvdByteLength > 0 ? (uint32_t)cur_offset : 0;
+    cur_offset += hdr.kvdByteLength;
+
+    if (!sgd.empty()) {
+        cur_offset = alignOffset(cur_offset, 8);
+        new_hdr.sgdByteOffset = cur_offset;
+        cur_offset += sgd.size();
+    } else {
+        new_hdr.sgdByteOffset = 0;
+    }
+    new_hdr.sgdByteLength = sgd.size();
+
+    // Level data is stored smallest level first
+    std::vector<KTX2Level> new_levels(new_num_levels);
+    for (int32_t i = (int32_t)new_num_levels - 1; i >= 0; i--) {
+        const KTX2Level &src_level = levels[i + num_skip];
+        cur_offset = alignOffset(cur_offset, level_alignment);
+
+        new_levels[i] = {
+            .byteOffset = cur_offset,
+            .byteLength = src_level.byteLength,
+            .uncompressedByteLength = src_level.uncompressedByteLength,
+        };
+
+        cur_offset += src_level.byteLength;
+    }
+
+    out.assign(cur_offset, 0);
+    memcpy(out.data(), &new_hdr, sizeof(KTX2Header));
+    memcpy(out.data() + sizeof(KTX2Header), new_levels.data(),
+           sizeof(KTX2Level) * new_num_levels);
+
+    if (hdr.dfdByteLength > 0) {
+        memcpy(out.data() + new_hdr.dfdByteOffset,
+               src + hdr.dfdByteOffset, hdr.dfdByteLength);
+    }
+
+    if (hdr.kvdByteLength > 0) {
+        memcpy(out.data() + new_hdr.kvdByteOffset,
+               src + hdr.kvdByteOffset, hdr.kvdByteLength);
+    }
+
+    if (!sgd.empty()) {
+        memcpy(out.data() + new_hdr.sgdByteOffset, sgd.data(), sgd.size());
+    }
+
+    for (uint32_t i = 0; i < new_num_levels; i++) {
+        memcpy(out.data() + new_levels[i].byteOffset,
+               src + levels[i + num_skip].byteOffset,
+               new_levels[i].byteLength);
+    }
+
+    return true;
+}
+
+}
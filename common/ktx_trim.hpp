@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+namespace run {
+
+// Largest texture dimension to import for the given batch view size:
+// MADRONA_TEXTURE_DIM if set (0 keeps full resolution), otherwise a few
+// texels per pixel of the view, rounded up to a power of two.
+uint32_t maxTextureDimForView(uint32_t view_width, uint32_t view_height);
+
+// Rewrites a KTX2 container into out without its largest mip levels, so the
+// new base level is at most max_dim in both dimensions. Dropped levels are
+// never transcoded. Returns false, leaving out untouched, if nothing can or
+// needs to be dropped (not KTX2, single level, 3D, already small enough).
+bool trimKTX2MipLevels(const void *data, size_t num_bytes,
+                       uint32_t max_dim, std::vector<uint8_t> &out);
+
+}
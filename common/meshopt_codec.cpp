@@ -0,0 +1,534 @@
+#include "meshopt_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace run {
+
+namespace {
+
+constexpr uint8_t vertexHeader = 0xa0;
+constexpr uint8_t indexHeader = 0xe0;
+constexpr uint8_t sequenceHeader = 0xd0;
+
+constexpr size_t byteGroupSize = 16;
+constexpr size_t vertexBlockSizeBytes = 8192;
+constexpr size_t vertexBlockMaxSize = 256;
+constexpr size_t vertexTailMinSize = 32;
+
+// Bounds-checked cursor over the encoded stream
+struct Reader {
+    const uint8_t *cur;
+    const uint8_t *end;
+
+    bool has(size_t num_bytes) const
+    {
+        return (size_t)(end - cur) >= num_bytes;
+    }
+};
+
+size_t vertexBlockSize(size_t stride)
+{
+    size_t result = (vertexBlockSizeBytes / stride) & ~(byteGroupSize - 1);
+    return std::min(result, vertexBlockMaxSize);
+}
+
+uint8_t unzigzag8(uint8_t v)
+{
+    return (uint8_t)(-(v & 1) ^ (v >> 1));
+}
+
+// One group of 16 bytes: all zero, 2 or 4 bits per byte with the largest
+// value escaping to a full byte stored after the packed bits, or raw.
+bool decodeBytesGroup(Reader &in, uint8_t *dst, uint32_t bits_log2)
+{
+    if (bits_log2 == 0) {
+        memset(dst, 0, byteGroupSize);
+        return true;
+    }
+
+    if (bits_log2 == 3) {
+        if (!in.has(byteGroupSize)) {
+            return false;
+        }
+
+        memcpy(dst, in.cur, byteGroupSize);
+        in.cur += byteGroupSize;
+        return true;
+    }
+
+    uint32_t bits = bits_log2 == 1 ? 2 : 4;
+    size_t packed_bytes = byteGroupSize * bits / 8;
+    if (!in.has(packed_bytes)) {
+        return false;
+    }
+
+    const uint8_t *packed = in.cur;
+    in.cur += packed_bytes;
+
+    uint32_t escape = (1u << bits) - 1;
+    uint32_t values_per_byte = 8 / bits;
+
+    for (size_t i = 0; i < byteGroupSize; i++) {
+        uint32_t shift = 8 - bits * (uint32_t)(i % values_per_byte + 1);
+        uint32_t v = (packed[i / values_per_byte] >> shift) & escape;
+
+        if (v == escape) {
+            if (!in.has(1)) {
+                return false;
+            }
+
+            v = *in.cur++;
+        }
+
+        dst[i] = (uint8_t)v;
+    }
+
+    return true;
+}
+
+bool decodeBytes(Reader &in, uint8_t *dst, size_t num_bytes)
+{
+    size_t num_groups = num_bytes / byteGroupSize;
+    size_t header_bytes = (num_groups + 3) / 4;
+    if (!in.has(header_bytes)) {
+        return false;
+    }
+
+    const uint8_t *header = in.cur;
+    in.cur += header_bytes;
+
+    for (size_t i = 0; i < num_groups; i++) {
+        uint32_t bits_log2 = (header[i / 4] >> ((i % 4) * 2)) & 3;
+        if (!decodeBytesGroup(in, dst + i * byteGroupSize, bits_log2)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Vertex bytes are stored transposed (byte k of every vertex together) as
+// deltas from the previous vertex.
+bool decodeVertexBlock(Reader &in, uint8_t *dst, size_t count,
+                       size_t stride, uint8_t *last_vertex)
+{
+    uint8_t deltas[vertexBlockMaxSize];
+    size_t count_aligned = (count + byteGroupSize - 1) & ~(byteGroupSize - 1);
+
+    for (size_t k = 0; k < stride; k++) {
+        if (!decodeBytes(in, deltas, count_aligned)) {
+            return false;
+        }
+
+        uint8_t p = last_vertex[k];
+        for (size_t i = 0; i < count; i++) {
+            uint8_t v = (uint8_t)(unzigzag8(deltas[i]) + p);
+            dst[i * stride + k] = v;
+            p = v;
+        }
+    }
+
+    memcpy(last_vertex, dst + (count - 1) * stride, stride);
+    return true;
+}
+
+bool decodeVByte(Reader &in, uint32_t &out)
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < 5; i++) {
+        if (!in.has(1)) {
+            return false;
+        }
+
+        uint8_t group = *in.cur++;
+        result |= (uint32_t)(group & 127) << (7 * i);
+        if (group < 128) {
+            out = result;
+            return true;
+        }
+    }
+
+    out = result;
+    return true;
+}
+
+bool decodeIndex(Reader &in, uint32_t &last)
+{
+    uint32_t v;
+    if (!decodeVByte(in, v)) {
+        return false;
+    }
+
+    last += (v >> 1) ^ (uint32_t)-(int32_t)(v & 1);
+    return true;
+}
+
+void writeIndex(void *dst, size_t idx, size_t stride, uint32_t v)
+{
+    if (stride == 2) {
+        ((uint16_t *)dst)[idx] = (uint16_t)v;
+    } else {
+        ((uint32_t *)dst)[idx] = v;
+    }
+}
+
+struct TriangleFifos {
+    uint32_t edges[16][2];
+    uint32_t vertices[16];
+    uint32_t edgeOffset = 0;
+    uint32_t vertexOffset = 0;
+
+    TriangleFifos()
+    {
+        memset(edges, 0xff, sizeof(edges));
+        memset(vertices, 0xff, sizeof(vertices));
+    }
+
+    void pushEdge(uint32_t a, uint32_t b)
+    {
+        edges[edgeOffset][0] = a;
+        edges[edgeOffset][1] = b;
+        edgeOffset = (edgeOffset + 1) & 15;
+    }
+
+    void pushVertex(uint32_t v, bool advance = true)
+    {
+        vertices[vertexOffset] = v;
+        vertexOffset = (vertexOffset + (advance ? 1 : 0)) & 15;
+    }
+};
+
+template <typename T>
+T roundToInt(float v)
+{
+    return (T)(int32_t)(v + (v >= 0.f ? 0.5f : -0.5f));
+}
+
+template <typename T>
+void octahedralFilter(T *data, size_t count)
+{
+    const float max = (float)((1 << (sizeof(T) * 8 - 1)) - 1);
+
+    for (size_t i = 0; i < count; i++) {
+        T *v = data + i * 4;
+
+        // z is stored as the encoded one minus |x| minus |y|
+        float x = (float)v[0];
+        float y = (float)v[1];
+        float z = (float)v[2] - fabsf(x) - fabsf(y);
+
+        // Unfold the lower hemisphere
+        float t = z < 0.f ? z : 0.f;
+        x += x >= 0.f ? t : -t;
+        y += y >= 0.f ? t : -t;
+
+        float len = sqrtf(x * x + y * y + z * z);
+        float s = len > 0.f ? max / len : 0.f;
+
+        v[0] = roundToInt<T>(x * s);
+        v[1] = roundToInt<T>(y * s);
+        v[2] = roundToInt<T>(z * s);
+    }
+}
+
+void quaternionFilter(int16_t *data, size_t count)
+{
+    const float scale = 1.f / sqrtf(2.f);
+
+    for (size_t i = 0; i < count; i++) {
+        int16_t *q = data + i * 4;
+
+        // The fourth component stores the range in its high bits and the
+        // index of the dropped (largest) component in its low 2 bits.
+        int32_t sf = q[3] | 3;
+        float ss = scale / (float)sf;
+
+        float x = (float)q[0] * ss;
+        float y = (float)q[1] * ss;
+        float z = (float)q[2] * ss;
+
+        float ww = 1.f - x * x - y * y - z * z;
+        float w = sqrtf(ww >= 0.f ? ww : 0.f);
+
+        int32_t qc = q[3] & 3;
+
+        q[(qc + 1) & 3] = roundToInt<int16_t>(x * 32767.f);
+        q[(qc + 2) & 3] = roundToInt<int16_t>(y * 32767.f);
+        q[(qc + 3) & 3] = roundToInt<int16_t>(z * 32767.f);
+        q[(qc + 0) & 3] = roundToInt<int16_t>(w * 32767.f);
+    }
+}
+
+void exponentialFilter(uint32_t *data, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        uint32_t v = data[i];
+
+        // 24 bit signed mantissa, 8 bit signed exponent
+        int32_t m = (int32_t)(v << 8) >> 8;
+        int32_t e = (int32_t)v >> 24;
+
+        float f = ldexpf((float)m, e);
+        memcpy(&data[i], &f, sizeof(float));
+    }
+}
+
+}
+
+bool decodeMeshoptVertexBuffer(void *dst, size_t count, size_t stride,
+                               const uint8_t *src, size_t src_size)
+{
+    if (stride == 0 || stride > 256 || stride % 4 != 0 ||
+            src_size < 1 + stride || (src[0] & 0xf0) != vertexHeader ||
+            (src[0] & 0x0f) != 0) {
+        return false;
+    }
+
+    // The first vertex, which deltas start from, ends the stream after
+    // zero padding up to vertexTailMinSize.
+    size_t tail_size = std::max(stride, vertexTailMinSize);
+    if (src_size < 1 + tail_size) {
+        return false;
+    }
+
+    uint8_t last_vertex[256];
+    memcpy(last_vertex, src + src_size - stride, stride);
+
+    Reader in { src + 1, src + src_size - tail_size };
+
+    size_t block_size = vertexBlockSize(stride);
+    uint8_t *out = (uint8_t *)dst;
+
+    for (size_t offset = 0; offset < count; offset += block_size) {
+        size_t block_count = std::min(block_size, count - offset);
+        if (!decodeVertexBlock(in, out + offset * stride, block_count,
+                               stride, last_vertex)) {
+            return false;
+        }
+    }
+
+    return in.cur == in.end;
+}
+
+bool decodeMeshoptIndexBuffer(void *dst, size_t count, size_t stride,
+                              const uint8_t *src, size_t src_size)
+{
+    if ((stride != 2 && stride != 4) || count % 3 != 0 ||
+            src_size < 1 + count / 3 + 16 ||
+            (src[0] & 0xf0) != indexHeader || (src[0] & 0x0f) > 1) {
+        return false;
+    }
+
+    uint32_t version = src[0] & 0x0f;
+
+    // One code byte per triangle, then variable length data, then a
+    // 16 byte table for the codes that reference it.
+    const uint8_t *codes = src + 1;
+    const uint8_t *code_aux_table = src + src_size - 16;
+    Reader in { codes + count / 3, code_aux_table };
+
+    TriangleFifos fifo;
+    uint32_t next = 0;
+    uint32_t last = 0;
+
+    // Version 1 encodes +-1 index deltas in the last two fifo codes
+    int32_t fec_max = version >= 1 ? 13 : 15;
+
+    for (size_t i = 0; i < count; i += 3) {
+        uint8_t code = *codes++;
+
+        if (code < 0xf0) {
+            // Edge from the fifo plus a cached, new or explicit vertex
+            uint32_t fe = code >> 4;
+            uint32_t a = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][0];
+            uint32_t b = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][1];
+
+            int32_t fec = code & 15;
+            uint32_t c;
+
+            if (fec < fec_max) {
+                bool is_new = fec == 0;
+                c = is_new ? next :
+                    fifo.vertices[(fifo.vertexOffset - 1 - fec) & 15];
+                next += is_new ? 1 : 0;
+
+                fifo.pushVertex(c, is_new);
+            } else {
+                if (fec != 15) {
+                    last += fec == 13 ? (uint32_t)-1 : 1u;
+                } else if (!decodeIndex(in, last)) {
+                    return false;
+                }
+
+                c = last;
+                fifo.pushVertex(c);
+            }
+
+            writeIndex(dst, i + 0, stride, a);
+            writeIndex(dst, i + 1, stride, b);
+            writeIndex(dst, i + 2, stride, c);
+
+            fifo.pushEdge(c, b);
+            fifo.pushEdge(a, c);
+        } else if (code < 0xfe) {
+            // New vertex plus two cached or new vertices described by the
+            // aux table
+            uint8_t code_aux = code_aux_table[code & 15];
+            uint32_t feb = code_aux >> 4;
+            uint32_t fec = code_aux & 15;
+
+            uint32_t a = next++;
+
+            uint32_t b = feb == 0 ? next :
+                fifo.vertices[(fifo.vertexOffset - feb) & 15];
+            next += feb == 0 ? 1 : 0;
+
+            uint32_t c = fec == 0 ? next :
+                fifo.vertices[(fifo.vertexOffset - fec) & 15];
+            next += fec == 0 ? 1 : 0;
+
+            writeIndex(dst, i + 0, stride, a);
+            writeIndex(dst, i + 1, stride, b);
+            writeIndex(dst, i + 2, stride, c);
+
+            fifo.pushVertex(a);
+            fifo.pushVertex(b, feb == 0);
+            fifo.pushVertex(c, fec == 0);
+
+            fifo.pushEdge(b, a);
+            fifo.pushEdge(c, b);
+            fifo.pushEdge(a, c);
+        } else {
+            // All three vertices spelled out by a following aux byte
+            if (!in.has(1)) {
+                return false;
+            }
+
+            uint8_t code_aux = *in.cur++;
+
+            uint32_t fea = code == 0xfe ? 0 : 15;
+            uint32_t feb = code_aux >> 4;
+            uint32_t fec = code_aux & 15;
+
+            // An all-zero aux byte restarts the new vertex counter
+            if (code_aux == 0) {
+                next = 0;
+            }
+
+            uint32_t a = fea == 0 ? next++ : 0;
+            uint32_t b = feb == 0 ? next++ :
+                fifo.vertices[(fifo.vertexOffset - feb) & 15];
+            uint32_t c = fec == 0 ? next++ :
+                fifo.vertices[(fifo.vertexOffset - fec) & 15];
+
+            if (fea == 15) {
+                if (!decodeIndex(in, last)) {
+                    return false;
+                }
+                a = last;
+            }
+
+            if (feb == 15) {
+                if (!decodeIndex(in, last)) {
+                    return false;
+                }
+                b = last;
+            }
+
+            if (fec == 15) {
+                if (!decodeIndex(in, last)) {
+                    return false;
+                }
+                c = last;
+            }
+
+            writeIndex(dst, i + 0, stride, a);
+            writeIndex(dst, i + 1, stride, b);
+            writeIndex(dst, i + 2, stride, c);
+
+            fifo.pushVertex(a);
+            fifo.pushVertex(b, feb == 0 || feb == 15);
+            fifo.pushVertex(c, fec == 0 || fec == 15);
+
+            fifo.pushEdge(b, a);
+            fifo.pushEdge(c, b);
+            fifo.pushEdge(a, c);
+        }
+    }
+
+    return in.cur == in.end;
+}
+
+bool decodeMeshoptIndexSequence(void *dst, size_t count, size_t stride,
+                                const uint8_t *src, size_t src_size)
+{
+    if ((stride != 2 && stride != 4) || src_size < 1 + count + 4 ||
+            (src[0] & 0xf0) != sequenceHeader || (src[0] & 0x0f) > 1) {
+        return false;
+    }
+
+    // Indices are deltas against one of two baselines, selected by the low
+    // bit. The stream ends with 4 bytes of padding.
+    Reader in { src + 1, src + src_size - 4 };
+    uint32_t last[2] = { 0, 0 };
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t v;
+        if (!decodeVByte(in, v)) {
+            return false;
+        }
+
+        uint32_t baseline = v & 1;
+        v >>= 1;
+
+        uint32_t index = last[baseline] + ((v >> 1) ^ (uint32_t)-(int32_t)(v & 1));
+        last[baseline] = index;
+
+        writeIndex(dst, i, stride, index);
+    }
+
+    return in.cur == in.end;
+}
+
+bool applyMeshoptFilter(MeshoptFilter filter, void *data,
+                        size_t count, size_t stride)
+{
+    switch (filter) {
+    case MeshoptFilter::None: {
+        return true;
+    }
+    case MeshoptFilter::Octahedral: {
+        if (stride == 4) {
+            octahedralFilter((int8_t *)data, count);
+            return true;
+        } else if (stride == 8) {
+            octahedralFilter((int16_t *)data, count);
+            return true;
+        }
+
+        return false;
+    }
+    case MeshoptFilter::Quaternion: {
+        if (stride != 8) {
+            return false;
+        }
+
+        quaternionFilter((int16_t *)data, count);
+        return true;
+    }
+    case MeshoptFilter::Exponential: {
+        if (stride % 4 != 0) {
+            return false;
+        }
+
+        exponentialFilter((uint32_t *)data, count * stride / 4);
+        return true;
+    }
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace run {
+
+// Decoders for the bitstreams of the glTF EXT_meshopt_compression
+// extension (meshoptimizer's vertex codec v0, index codec v0/v1 and index
+// sequence codec), plus its filters. All of them return false on malformed
+// input instead of reading past src_size.
+
+// mode ATTRIBUTES: count elements of stride bytes (a multiple of 4, at
+// most 256)
+bool decodeMeshoptVertexBuffer(void *dst, size_t count, size_t stride,
+                               const uint8_t *src, size_t src_size);
+
+// mode TRIANGLES: count indices of stride 2 or 4 bytes
+bool decodeMeshoptIndexBuffer(void *dst, size_t count, size_t stride,
+                              const uint8_t *src, size_t src_size);
+
+// mode INDICES: count indices of stride 2 or 4 bytes
+bool decodeMeshoptIndexSequence(void *dst, size_t count, size_t stride,
+                                const uint8_t *src, size_t src_size);
+
+enum class MeshoptFilter {
+    None,
+    Octahedral,
+    Quaternion,
+    Exponential,
+};
+
+// Applied in place to the output of decodeMeshoptVertexBuffer
+bool applyMeshoptFilter(MeshoptFilter filter, void *data,
+                        size_t count, size_t stride);
+
+}
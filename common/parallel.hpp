@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace run {
+
+// Number of threads used for host-side load work (JSON parsing, asset
+// import, ...). Can be overridden with MADRONA_LOAD_THREADS.
+inline uint32_t numLoadThreads()
+{
+    const char *num_threads_str = getenv("MADRONA_LOAD_THREADS");
+    if (num_threads_str) {
+        return (uint32_t)std::max(std::stoi(num_threads_str), 1);
+    }
+
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Calls fn(i) for every i in [0, count) on up to num_threads threads.
+// Indices are handed out dynamically, so callers that need a deterministic
+// result should write into per-index output slots.
+template <typename Fn>
+inline void parallelFor(uint64_t count, uint32_t num_threads, Fn &&fn)
+{
+    num_threads = (uint32_t)std::min<uint64_t>(num_threads, count);
+
+    if (num_threads <= 1) {
+        for (uint64_t i = 0; i < count; i++) {
+            fn(i);
+        }
+
+        return;
+    }
+
+    std::atomic<uint64_t> next_idx { 0 };
+    auto worker = [&]() {
+        uint64_t idx;
+        while ((idx = next_idx.fetch_add(1, std::memory_order_relaxed)) <
+               count) {
+            fn(idx);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (uint32_t i = 0; i < num_threads - 1; i++) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+
+}
@@ -0,0 +1,158 @@
+#include "scene_merge.hpp"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace madrona;
+using namespace madrona::math;
+
+namespace run {
+
+namespace {
+
+struct MergedMesh {
+    uint32_t materialIDX;
+    std::vector<Vector3> positions;
+    std::vector<Vector3> normals;
+    std::vector<Vector4> tangentAndSigns;
+    std::vector<Vector2> uvs;
+    std::vector<uint32_t> indices;
+    bool hasNormals = false;
+    bool hasTangents = false;
+    bool hasUVs = false;
+};
+
+struct MergedStorage {
+    std::vector<MergedMesh> meshes;
+    std::vector<imp::SourceMesh> sourceMeshes;
+};
+
+Vector3 normalizeOr(Vector3 v, Vector3 fallback)
+{
+    return v.length2() > 0.f ? v.normalize() : fallback;
+}
+
+void appendMesh(MergedMesh &dst,
+                const imp::SourceMesh &src,
+                const InstanceTransform &xform)
+{
+    const Diag3x3 &s = xform.scale;
+    const Quat &r = xform.rotation;
+
+    // Mirroring transforms flip the winding and tangent frame
+    bool mirrored = s.d0 * s.d1 * s.d2 < 0.f;
+
+    uint32_t base_vertex = (uint32_t)dst.positions.size();
+
+    dst.hasNormals |= src.normals != nullptr;
+    dst.hasTangents |= src.tangentAndSigns != nullptr;
+    dst.hasUVs |= src.uvs != nullptr;
+
+    for (uint32_t i = 0; i < src.numVertices; i++) {
+        Vector3 p = src.positions[i];
+        dst.positions.push_back(xform.position +
+            r.rotateVec({ p.x * s.d0, p.y * s.d1, p.z * s.d2 }));
+
+        // Normals transform by the inverse transpose, which for a rotation
+        // times a scale is the rotation times the inverse scale.
+        Vector3 n = src.normals ? src.normals[i] : Vector3 { 0.f, 0.f, 1.f };
+        dst.normals.push_back(normalizeOr(
+            r.rotateVec({ n.x / s.d0, n.y / s.d1, n.z / s.d2 }),
+            { 0.f, 0.f, 1.f }));
+
+        Vector4 t = src.tangentAndSigns ? src.tangentAndSigns[i] :
+            Vector4 { 1.f, 0.f, 0.f, 1.f };
+        Vector3 tangent = normalizeOr(
+            r.rotateVec({ t.x * s.d0, t.y * s.d1, t.z * s.d2 }),
+            { 1.f, 0.f, 0.f });
+        dst.tangentAndSigns.push_back({
+            tangent.x, tangent.y, tangent.z, mirrored ? -t.w : t.w });
+
+        dst.uvs.push_back(src.uvs ? src.uvs[i] : Vector2 { 0.f, 0.f });
+    }
+
+    auto addTriangle = [&](uint32_t a, uint32_t b, uint32_t c) {
+        if (mirrored) {
+            std::swap(b, c);
+        }
+
+        dst.indices.push_back(base_vertex + a);
+        dst.indices.push_back(base_vertex + b);
+        dst.indices.push_back(base_vertex + c);
+    };
+
+    if (src.faceCounts == nullptr) {
+        for (uint32_t i = 0; i < src.numFaces; i++) {
+            const uint32_t *tri = src.indices + i * 3;
+            addTriangle(tri[0], tri[1], tri[2]);
+        }
+    } else {
+        // Polygons are triangulated as fans
+        const uint32_t *face = src.indices;
+        for (uint32_t i = 0; i < src.numFaces; i++) {
+            for (uint32_t j = 2; j < src.faceCounts[i]; j++) {
+                addTriangle(face[0], face[j - 1], face[j]);
+            }
+
+            face += src.faceCounts[i];
+        }
+    }
+}
+
+}
+
+MergedObject mergeInstances(Span<const imp::SourceObject> objects,
+                            Span<const InstanceTransform> instances)
+{
+    auto storage = std::make_shared<MergedStorage>();
+
+    std::unordered_map<uint32_t, uint32_t> material_meshes;
+
+    for (const InstanceTransform &inst : instances) {
+        const imp::SourceObject &obj = objects[inst.objectID];
+
+        for (const imp::SourceMesh &mesh : obj.meshes) {
+            auto [iter, inserted] = material_meshes.emplace(
+                mesh.materialIDX, (uint32_t)storage->meshes.size());
+
+            if (inserted) {
+                storage->meshes.push_back({
+                    .materialIDX = mesh.materialIDX,
+                });
+            }
+
+            appendMesh(storage->meshes[iter->second], mesh, inst);
+        }
+    }
+
+    storage->sourceMeshes.reserve(storage->meshes.size());
+    for (MergedMesh &mesh : storage->meshes) {
+        storage->sourceMeshes.push_back({
+            .positions = mesh.positions.data(),
+            .normals = mesh.hasNormals ? mesh.normals.data() : nullptr,
+            .tangentAndSigns = mesh.hasTangents ?
+                mesh.tangentAndSigns.data() : nullptr,
+            .uvs = mesh.hasUVs ? mesh.uvs.data() : nullptr,
+            .indices = mesh.indices.data(),
+            .faceCounts = nullptr,
+            .faceMaterials = nullptr,
+            .numVertices = (uint32_t)mesh.positions.size(),
+            .numFaces = (uint32_t)(mesh.indices.size() / 3),
+            .materialIDX = mesh.materialIDX,
+        });
+    }
+
+    imp::SourceObject object {
+        .meshes = Span<imp::SourceMesh>(
+            storage->sourceMeshes.data(),
+            (CountT)storage->sourceMeshes.size()),
+    };
+
+    return MergedObject {
+        .object = object,
+        .storage = std::move(storage),
+    };
+}
+
+}
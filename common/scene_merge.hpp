@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include <madrona/importer.hpp>
+#include <madrona/math.hpp>
+#include <madrona/span.hpp>
+
+namespace run {
+
+namespace imp = madrona::imp;
+
+struct InstanceTransform {
+    madrona::math::Vector3 position;
+    madrona::math::Quat rotation;
+    madrona::math::Diag3x3 scale;
+    uint32_t objectID;
+};
+
+// A single object replacing a set of static instances. storage owns the
+// geometry object points to.
+struct MergedObject {
+    imp::SourceObject object;
+    std::shared_ptr<void> storage;
+};
+
+// Bakes the transforms of instances into their geometry and combines all
+// meshes sharing a material into one, so a scene renders as a handful of
+// meshes with one instance instead of thousands. Geometry of objects
+// instanced several times is duplicated, trading memory for fewer
+// instances and BVH leaves.
+MergedObject mergeInstances(madrona::Span<const imp::SourceObject> objects,
+                            madrona::Span<const InstanceTransform> instances);
+
+}
@@ -13,6 +13,10 @@ inline constexpr madrona::CountT numRooms = 3;
 // inline constexpr madrona::CountT numAgents = 1;
 inline constexpr madrona::CountT maxAgents = 16;
 
+// Scene instances created by each init task invocation. Worlds spawn their
+// instances in chunks of this size in parallel rather than one by one.
+inline constexpr uint32_t instancesPerSpawner = 64;
+
 // Maximum number of interactive objects per challenge room. This is needed
 // in order to setup the fixed-size learning tensors appropriately.
 inline constexpr madrona::CountT maxEntitiesPerRoom = 16;
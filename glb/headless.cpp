@@ -3,17 +3,26 @@
 #include "dump.hpp"
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <chrono>
 #include <string>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <vector>
+
+#include <unistd.h>
 
 #include <stb_image_write.h>
 #include <madrona/window.hpp>
 #include <madrona/heap_array.hpp>
 #include <madrona/render/render_mgr.hpp>
 
+#ifdef MADRONA_CUDA_SUPPORT
+#include <madrona/cuda_utils.hpp>
+#endif
+
 using namespace madrona;
 
 [[maybe_unused]] static void saveWorldActions(
@@ -28,6 +37,108 @@ using namespace madrona;
             sizeof(uint32_t) * total_num_steps * 2 * 3);
 }
 
+// One instance count configuration of the GLB_INSTANCES sweep
+struct InstanceConfig {
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t randomInstances;
+};
+
+struct SweepResult {
+    InstanceConfig config;
+    uint32_t numInstances;
+    double initSeconds;
+    double fps;
+    double stepMS;
+    // Growth over the course of init, so negative if memory freed by
+    // the previous configuration was returned meanwhile
+    int64_t hostBytes;
+    int64_t gpuBytes;
+};
+
+// GLB_INSTANCES is a comma separated list of NxM grids and K random
+// placements, e.g. 1x1,8x8,32x32 or 100,1000,10000. Defaults to one copy.
+static std::vector<InstanceConfig> instanceConfigsFromEnv()
+{
+    std::vector<InstanceConfig> configs;
+
+    const char *list = getenv("GLB_INSTANCES");
+    if (!list || list[0] == '\0') {
+        configs.push_back({ 1, 1, 0 });
+        return configs;
+    }
+
+    const char *cur = list;
+    while (*cur != '\0') {
+        char *end;
+        unsigned long a = strtoul(cur, &end, 10);
+        bool valid = end != cur && a > 0;
+
+        InstanceConfig config;
+        if (*end == 'x') {
+            const char *b_start = end + 1;
+            unsigned long b = strtoul(b_start, &end, 10);
+            valid = valid && end != b_start && b > 0;
+
+            config = { (uint32_t)a, (uint32_t)b, 0 };
+        } else {
+            config = { 1, 1, (uint32_t)a };
+        }
+
+        if (!valid || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Invalid GLB_INSTANCES entry in \"%s\"\n", list);
+            exit(1);
+        }
+
+        configs.push_back(config);
+        cur = *end == ',' ? end + 1 : end;
+    }
+
+    return configs;
+}
+
+// Current resident set size of the process
+static uint64_t hostResidentBytes()
+{
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+
+    unsigned long total_pages = 0, resident_pages = 0;
+    int num_read = fscanf(statm, "%lu %lu", &total_pages, &resident_pages);
+    fclose(statm);
+
+    if (num_read != 2) {
+        return 0;
+    }
+
+    return (uint64_t)resident_pages * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+// Device memory in use on the current GPU, by any process
+static uint64_t gpuUsedBytes()
+{
+#ifdef MADRONA_CUDA_SUPPORT
+    size_t free_bytes, total_bytes;
+    if (cudaMemGetInfo(&free_bytes, &total_bytes) == cudaSuccess) {
+        return total_bytes - free_bytes;
+    }
+#endif
+
+    return 0;
+}
+
+static std::string instanceConfigName(const InstanceConfig &config)
+{
+    if (config.randomInstances > 0) {
+        return std::to_string(config.randomInstances) + " random";
+    }
+
+    return std::to_string(config.gridWidth) + "x" +
+        std::to_string(config.gridHeight) + " grid";
+}
+
 int main(int argc, char *argv[])
 {
     using namespace madEscape;
@@ -36,7 +147,8 @@ int main(int argc, char *argv[])
 
     std::string glb_path = argv[args.argCounter];
 
-    ExecMode exec_mode = ExecMode::CUDA;
+    ExecMode exec_mode = args.execBackend == run::ExecBackend::CPU ?
+        ExecMode::CPU : ExecMode::CUDA;
     uint64_t num_worlds = args.numWorlds;
     uint64_t num_steps = args.numSteps;
 
@@ -45,39 +157,111 @@ int main(int argc, char *argv[])
 
     uint32_t output_resolution = args.batchRenderWidth;
 
-    Manager mgr({
-        .execMode = exec_mode,
-        .gpuID = 0,
-        .numWorlds = (uint32_t)num_worlds,
-        .autoReset = false,
-        .enableBatchRenderer = enable_batch_renderer,
-        .batchRenderViewWidth = output_resolution,
-        .batchRenderViewHeight = output_resolution,
-        .raycastOutputResolution = output_resolution,
-        .headlessMode = true,
-        .glbPath = glb_path
-    });
-
-    auto start = std::chrono::system_clock::now();
-
-    for (CountT i = 0; i < (CountT)num_steps; i++) {
-        mgr.step();
+    // GLB_INSTANCE_SPACING overrides the distance between copies
+    float instance_spacing = 20.f;
+    if (const char *spacing_str = getenv("GLB_INSTANCE_SPACING")) {
+        instance_spacing = std::stof(spacing_str);
     }
 
-    if (args.dumpOutputFile) {
-        run::dumpTiledImage({
-            .outputPath = args.outputFileName,
-            .gpuTensor = (void *)mgr.raycastTensor().devicePtr(),
-            .numImages = (uint32_t)num_worlds,
-            .imageResolution = output_resolution
+    std::vector<InstanceConfig> instance_configs = instanceConfigsFromEnv();
+    std::vector<SweepResult> results;
+
+    // Each configuration gets a fresh Manager, so init time and memory
+    // cover loading and spawning that many instances per world. Assets
+    // come from the cache after the first one.
+    for (const InstanceConfig &instance_config : instance_configs) {
+        Manager::Config mgr_cfg {
+            .execMode = exec_mode,
+            .gpuID = 0,
+            .numWorlds = (uint32_t)num_worlds,
+            .autoReset = false,
+            .enableBatchRenderer = enable_batch_renderer,
+            .batchRenderViewWidth = output_resolution,
+            .batchRenderViewHeight = output_resolution,
+            .raycastOutputResolution = output_resolution,
+            .headlessMode = true,
+            .glbPath = glb_path,
+            .glbGridWidth = instance_config.gridWidth,
+            .glbGridHeight = instance_config.gridHeight,
+            .glbRandomInstances = instance_config.randomInstances,
+            .glbInstanceSpacing = instance_spacing,
+        };
+
+        uint32_t num_instances = Manager::numGLBInstances(mgr_cfg);
+
+        printf("Instances per world: %s (%u)\n",
+               instanceConfigName(instance_config).c_str(), num_instances);
+
+        uint64_t host_bytes_before = hostResidentBytes();
+        uint64_t gpu_bytes_before = gpuUsedBytes();
+
+        auto init_start = std::chrono::system_clock::now();
+
+        Manager mgr(mgr_cfg);
+
+        std::chrono::duration<double> init_elapsed =
+            std::chrono::system_clock::now() - init_start;
+        printf("Init time: %f s\n", init_elapsed.count());
+
+        int64_t host_bytes =
+            (int64_t)hostResidentBytes() - (int64_t)host_bytes_before;
+        int64_t gpu_bytes =
+            (int64_t)gpuUsedBytes() - (int64_t)gpu_bytes_before;
+        printf("Init memory: host %.1f MiB, GPU %.1f MiB\n",
+               (double)host_bytes / (1024.0 * 1024.0),
+               (double)gpu_bytes / (1024.0 * 1024.0));
+
+        auto start = std::chrono::system_clock::now();
+
+        for (CountT i = 0; i < (CountT)num_steps; i++) {
+            mgr.step();
+        }
+
+        auto end = std::chrono::system_clock::now();
+
+        if (&instance_config == &instance_configs.back()) {
+            if (args.dumpOutputFile && exec_mode == ExecMode::CPU) {
+                fprintf(stderr, "--dump-last-frame needs the raycaster, which is CUDA only\n");
+            } else if (args.dumpOutputFile) {
+                run::dumpTiledImage({
+                    .outputPath = args.outputFileName,
+                    .gpuTensor = (void *)mgr.raycastTensor().devicePtr(),
+                    .numImages = (uint32_t)num_worlds,
+                    .imageResolution = output_resolution
+                });
+            }
+        }
+
+        std::chrono::duration<double> elapsed = end - start;
+
+        float fps = (double)num_steps * (double)num_worlds / elapsed.count();
+        printf("FPS %f\n", fps);
+        printf("Average total step time: %f ms\n",
+               1000.0f * elapsed.count() / (double)num_steps);
+
+        results.push_back({
+            .config = instance_config,
+            .numInstances = num_instances,
+            .initSeconds = init_elapsed.count(),
+            .fps = fps,
+            .stepMS = 1000.0 * elapsed.count() / (double)num_steps,
+            .hostBytes = host_bytes,
+            .gpuBytes = gpu_bytes,
         });
     }
 
-    auto end = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    if (results.size() > 1) {
+        printf("\n%-16s %10s %10s %12s %10s %10s %10s\n", "config",
+               "instances", "init (s)", "FPS", "step (ms)", "host MiB",
+               "GPU MiB");
 
-    float fps = (double)num_steps * (double)num_worlds / elapsed.count();
-    printf("FPS %f\n", fps);
-    printf("Average total step time: %f ms\n",
-           1000.0f * elapsed.count() / (double)num_steps);
+        for (const SweepResult &result : results) {
+            printf("%-16s %10u %10.3f %12.1f %10.3f %10.1f %10.1f\n",
+                   instanceConfigName(result.config).c_str(),
+                   result.numInstances, result.initSeconds,
+                   result.fps, result.stepMS,
+                   (double)result.hostBytes / (1024.0 * 1024.0),
+                   (double)result.gpuBytes / (1024.0 * 1024.0));
+        }
+    }
 }
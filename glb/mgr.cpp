@@ -1,5 +1,10 @@
 #include "mgr.hpp"
 #include "sim.hpp"
+#include "asset_cache.hpp"
+#include "asset_import.hpp"
+#include "ktx_import.hpp"
+#include "camera_trajectory.hpp"
+#include "parallel.hpp"
 
 #include <random>
 #include <numeric>
@@ -98,12 +103,18 @@ static inline Optional<render::RenderManager> initRenderManager(
         .agentViewHeight = mgr_cfg.batchRenderViewHeight,
         .numWorlds = mgr_cfg.numWorlds,
         .maxViewsPerWorld = consts::maxAgents,
-        .maxInstancesPerWorld = 1024,
+        .maxInstancesPerWorld =
+            std::max(1024u, Manager::numGLBInstances(mgr_cfg) + 1),
         .execMode = mgr_cfg.execMode,
         .voxelCfg = {},
     });
 }
 
+struct LoadResult {
+    std::vector<ImportedInstance> importedInstances;
+    std::vector<UniqueScene> uniqueSceneInfos;
+};
+
 struct Manager::Impl {
     Config cfg;
     Action *agentActionsBuffer;
@@ -127,6 +138,9 @@ struct Manager::Impl {
 
     inline virtual ~Impl() {}
 
+    // Runs the Init graph once, after the worlds are constructed
+    virtual void initWorlds() = 0;
+
     virtual void run() = 0;
 
     virtual Tensor exportTensor(ExportID slot,
@@ -136,6 +150,53 @@ struct Manager::Impl {
     static inline Impl * init(const Config &cfg);
 };
 
+struct Manager::CPUImpl final : Manager::Impl {
+    using TaskGraphT =
+        TaskGraphExecutor<Engine, Sim, Sim::Config, Sim::WorldInit>;
+
+    // Sim::Config points into these, so they live as long as the worlds
+    LoadResult loadResult;
+    std::unique_ptr<run::CameraTrajectory> cameraTrajectory;
+    TaskGraphT cpuExec;
+
+    inline CPUImpl(const Manager::Config &mgr_cfg,
+                   Action *action_buffer,
+                   Optional<RenderGPUState> &&render_gpu_state,
+                   Optional<render::RenderManager> &&render_mgr,
+                   LoadResult &&load_result,
+                   std::unique_ptr<run::CameraTrajectory> &&camera_trajectory,
+                   TaskGraphT &&cpu_exec)
+        : Impl(mgr_cfg,
+               action_buffer,
+               std::move(render_gpu_state), std::move(render_mgr),
+               mgr_cfg.raycastOutputResolution),
+          loadResult(std::move(load_result)),
+          cameraTrajectory(std::move(camera_trajectory)),
+          cpuExec(std::move(cpu_exec))
+    {}
+
+    inline virtual ~CPUImpl() final {}
+
+    inline virtual void initWorlds()
+    {
+        cpuExec.runTaskGraph(TaskGraphID::Init);
+    }
+
+    inline virtual void run()
+    {
+        cpuExec.runTaskGraph(TaskGraphID::Step);
+        cpuExec.runTaskGraph(TaskGraphID::Render);
+    }
+
+    virtual inline Tensor exportTensor(ExportID slot,
+        TensorElementType type,
+        madrona::Span<const int64_t> dims) const final
+    {
+        void *dev_ptr = cpuExec.getExported((uint32_t)slot);
+        return Tensor(dev_ptr, type, dims, Optional<int>::none());
+    }
+};
+
 #ifdef MADRONA_CUDA_SUPPORT
 struct Manager::CUDAImpl final : Manager::Impl {
     MWCudaExecutor gpuExec;
@@ -163,6 +224,14 @@ struct Manager::CUDAImpl final : Manager::Impl {
 
     inline virtual ~CUDAImpl() final {}
 
+    inline virtual void initWorlds()
+    {
+        MWCudaLaunchGraph init_graph =
+            gpuExec.buildLaunchGraph(TaskGraphID::Init);
+
+        gpuExec.run(init_graph);
+    }
+
     inline virtual void run()
     {
         gpuExec.run(stepGraph);
@@ -181,36 +250,126 @@ struct Manager::CUDAImpl final : Manager::Impl {
         return Tensor(dev_ptr, type, dims, cfg.gpuID);
     }
 };
-#else
-static_assert(false, "This only works with the CUDA backend");
 #endif
 
-static Optional<imp::SourceTexture> ktxImageImportFn(
-        void *data, size_t num_bytes)
+// Largest texture dimension ktxImageImportFn imports, 0 for full
+// resolution. Image handlers are plain function pointers, so the importer
+// configure callback stores the dimension for the import thread it runs on.
+static thread_local uint32_t ktxMaxTextureDim = 0;
+
+static bool transcodeKTX(const void *data, size_t num_bytes,
+                         run::TranscodedTexture &out)
 {
     ktx::ConvertedOutput converted = {};
     ktx::loadKTXMem(data, num_bytes, &converted);
 
-    return imp::SourceTexture {
+    if (converted.textureData == nullptr) {
+        return false;
+    }
+
+    out = run::TranscodedTexture {
         .data = converted.textureData,
-        .format = imp::SourceTextureFormat::BC7,
         .width = (uint32_t)converted.width,
         .height = (uint32_t)converted.height,
-        .numBytes = converted.bufferSize
+        .numBytes = converted.bufferSize,
     };
+
+    return true;
 }
 
-struct LoadResult {
-    std::vector<ImportedInstance> importedInstances;
-    std::vector<UniqueScene> uniqueSceneInfos;
-};
+static Optional<imp::SourceTexture> ktxImageImportFn(
+        void *data, size_t num_bytes)
+{
+    return run::importKTX2Texture(data, num_bytes, ktxMaxTextureDim,
+        std::filesystem::path(DATA_DIR) / "cache", transcodeKTX);
+}
+
+static void configureImporter(imp::AssetImporter &importer,
+                              uint32_t max_texture_dim)
+{
+    ktxMaxTextureDim = max_texture_dim;
+
+    // Setup importer to handle KTX images
+    imp::ImageImporter &img_importer = importer.imageImporter();
+    img_importer.addHandler("ktx2", ktxImageImportFn);
+}
+
+
+static void loadRenderObjects(
+        Optional<render::RenderManager> &render_mgr,
+        const run::LoadedAssets &assets)
+{
+    if (render_mgr.has_value()) {
+        render_mgr->loadObjects(assets.objects(),
+                assets.materials(),
+                assets.textures());
+
+        render_mgr->configureLighting({
+            { true, math::Vector3{1.0f, -1.0f, -0.05f}, 
+              math::Vector3{1.0f, 1.0f, 1.0f} }
+        });
+    }
+}
+
+// Places Manager::numGLBInstances copies of the GLB (object 0) around the
+// origin, on a grid or at random positions and headings
+static void placeGLBInstances(const Manager::Config &mgr_cfg,
+                              std::vector<ImportedInstance> &instances)
+{
+    Quat glb_rotation = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f });
+    float spacing = mgr_cfg.glbInstanceSpacing;
+
+    auto addInstance = [&](float x, float y, Quat rotation) {
+        instances.push_back({
+            .position = { x, y, 0.f },
+            .rotation = rotation,
+            .scale = Diag3x3{ 10.f, 10.f, 10.f },
+            .objectID = 0
+        });
+    };
+
+    if (mgr_cfg.glbRandomInstances > 0) {
+        uint32_t num_instances = mgr_cfg.glbRandomInstances;
+
+        // Same area a square grid of as many instances would cover
+        float extent = spacing * sqrtf((float)num_instances);
+
+        std::mt19937 rng(mgr_cfg.randSeed);
+        std::uniform_real_distribution<float> pos_dist(
+            -extent / 2.f, extent / 2.f);
+        std::uniform_real_distribution<float> yaw_dist(0.f, 2.f * pi);
+
+        for (uint32_t i = 0; i < num_instances; i++) {
+            float x = pos_dist(rng);
+            float y = pos_dist(rng);
+            Quat yaw = Quat::angleAxis(yaw_dist(rng), math::up);
+
+            addInstance(x, y, (yaw * glb_rotation).normalize());
+        }
+
+        return;
+    }
 
+    float offset_x = spacing * (float)(mgr_cfg.glbGridWidth - 1) / 2.f;
+    float offset_y = spacing * (float)(mgr_cfg.glbGridHeight - 1) / 2.f;
+
+    for (uint32_t y = 0; y < mgr_cfg.glbGridHeight; y++) {
+        for (uint32_t x = 0; x < mgr_cfg.glbGridWidth; x++) {
+            addInstance(spacing * (float)x - offset_x,
+                        spacing * (float)y - offset_y,
+                        glb_rotation);
+        }
+    }
+}
 
-static imp::ImportedAssets loadGLB(
+static run::LoadedAssets loadGLB(
         Optional<render::RenderManager> &render_mgr,
-        const std::string &glb_path,
+        const Manager::Config &mgr_cfg,
+        uint32_t max_texture_dim,
         LoadResult &load_result)
 {
+    const std::string &glb_path = mgr_cfg.glbPath;
+
     std::vector<std::string> render_asset_paths;
 
     // Object 0 is the glb object
@@ -223,12 +382,7 @@ static imp::ImportedAssets loadGLB(
 
     printf("GLB path to render: %s\n", render_asset_paths[0].c_str());
 
-    load_result.importedInstances.push_back({
-        .position = { 0.f, 0.f, 0.f },
-        .rotation = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }),
-        .scale = Diag3x3{ 10.f, 10.f, 10.f },
-        .objectID = 0
-    });
+    placeGLBInstances(mgr_cfg, load_result.importedInstances);
 
     load_result.importedInstances.push_back({
         .position = { 0.f, 0.f, 0.f },
@@ -238,50 +392,117 @@ static imp::ImportedAssets loadGLB(
     });
 
     load_result.uniqueSceneInfos.push_back({
-        2, 0, 2, { 0.f, 0.f, 0.f }
+        (uint32_t)load_result.importedInstances.size(), 0, 2,
+        { 0.f, 0.f, 0.f }
     });
 
-    std::vector<const char *> render_asset_cstrs;
-    for (size_t i = 0; i < render_asset_paths.size(); i++)
-        render_asset_cstrs.push_back(render_asset_paths[i].c_str());
+    // The instances are rebuilt from the config on every run and aren't
+    // cached, so one bake serves every placement. The GLB and plane are
+    // checked when mapping.
+    bool use_asset_cache = run::assetCacheEnabled();
+    uint64_t cache_key = run::hashString("glb_assets", 0);
+    cache_key = run::hashValue(max_texture_dim, cache_key);
+    for (const std::string &path : render_asset_paths) {
+        cache_key = run::hashString(path, cache_key);
+    }
 
-    imp::AssetImporter importer;
+    std::filesystem::path cache_path = run::assetCachePath(
+        std::filesystem::path(DATA_DIR) / "cache", "glb", cache_key);
 
-    // Setup importer to handle KTX images
-    imp::ImageImporter &img_importer = importer.imageImporter();
-    img_importer.addHandler("ktx2", ktxImageImportFn);
+    if (use_asset_cache) {
+        auto cached = run::AssetCache::load(cache_path, cache_key);
+        if (cached.has_value()) {
+            printf("Loaded baked GLB from %s\n", cache_path.c_str());
 
-    std::array<char, 1024> import_err;
-    auto render_assets = importer.importFromDisk(
-        render_asset_cstrs, Span<char>(import_err.data(), import_err.size()),
-        true);
+            run::LoadedAssets assets {
+                .cached = std::move(cached),
+            };
+
+            loadRenderObjects(render_mgr, assets);
+
+            return assets;
+        }
+    }
 
-    if (!render_assets.has_value()) {
+    run::LoadedAssets assets {
+        .cached = Optional<run::AssetCache>::none(),
+    };
+
+    std::array<char, 1024> import_err;
+    if (!run::importAssetsParallel(
+            Span<const std::string>(
+                render_asset_paths.data(), render_asset_paths.size()),
+            run::numLoadThreads(),
+            [max_texture_dim](imp::AssetImporter &importer) {
+                configureImporter(importer, max_texture_dim);
+            },
+            std::filesystem::path(DATA_DIR) / "cache", assets,
+            Span<char>(import_err.data(), import_err.size()))) {
         FATAL("Failed to load render assets: %s", import_err);
     }
 
-    render_assets->materials.push_back({
+    assets.importedMaterials.push_back({
         .color = { 1.f, 1.f, 1.f, 1.f },
         .textureIdx = -1,
         .roughness = 1.f,
         .metalness = 0.1f,
     });
 
-    render_assets->objects[1].meshes[0].materialIDX = 
-        render_assets->materials.size() - 1;
+    assets.importedObjects[1].meshes[0].materialIDX = 
+        assets.importedMaterials.size() - 1;
 
-    if (render_mgr.has_value()) {
-        render_mgr->loadObjects(render_assets->objects, 
-                render_assets->materials,
-                render_assets->textures);
+    if (use_asset_cache) {
+        if (run::writeAssetCache(cache_path, cache_key,
+                Span<const run::AssetCacheSection>(nullptr, 0),
+                Span<const std::string>(
+                    render_asset_paths.data(), render_asset_paths.size()),
+                assets.objects(), assets.materials(), assets.textures())) {
+            printf("Baked GLB to %s\n", cache_path.c_str());
+        }
+    }
 
-        render_mgr->configureLighting({
-            { true, math::Vector3{1.0f, -1.0f, -0.05f}, 
-              math::Vector3{1.0f, 1.0f, 1.0f} }
-        });
+    loadRenderObjects(render_mgr, assets);
+
+    return assets;
+}
+
+// Textures only need to be as detailed as the views rendering them
+static uint32_t importTextureDim(const Manager::Config &mgr_cfg)
+{
+    uint32_t view_width = mgr_cfg.enableBatchRenderer ?
+        mgr_cfg.batchRenderViewWidth : mgr_cfg.raycastOutputResolution;
+    uint32_t view_height = mgr_cfg.enableBatchRenderer ?
+        mgr_cfg.batchRenderViewHeight : mgr_cfg.raycastOutputResolution;
+
+    return run::maxTextureDimForView(view_width, view_height);
+}
+
+// Points sim_cfg at the MADRONA_CAMERA_TRAJECTORY poses, if set. The
+// returned mapping must outlive the worlds when they read it directly.
+static std::unique_ptr<run::CameraTrajectory> loadCameraTrajectory(
+    Sim::Config &sim_cfg)
+{
+    static_assert(sizeof(TrajectoryPose) ==
+        sizeof(float) * run::CameraTrajectory::floatsPerPose);
+
+    // Worlds have a single camera
+    std::unique_ptr<run::CameraTrajectory> trajectory =
+        run::cameraTrajectoryFromEnv(1);
+
+    if (!trajectory) {
+        sim_cfg.trajectoryPoses = nullptr;
+        sim_cfg.numTrajectories = 0;
+        sim_cfg.trajectoryViews = 0;
+        sim_cfg.trajectoryLen = 0;
+        return nullptr;
     }
 
-    return std::move(*render_assets);
+    sim_cfg.trajectoryPoses = (const TrajectoryPose *)trajectory->poses();
+    sim_cfg.numTrajectories = trajectory->numTrajectories();
+    sim_cfg.trajectoryViews = trajectory->numViews();
+    sim_cfg.trajectoryLen = trajectory->numSteps();
+
+    return trajectory;
 }
 
 Manager::Impl * Manager::Impl::init(
@@ -299,6 +520,9 @@ Manager::Impl * Manager::Impl::init(
         sim_cfg.numAgents = 1;
     }
 
+    std::unique_ptr<run::CameraTrajectory> camera_trajectory =
+        loadCameraTrajectory(sim_cfg);
+
     switch (mgr_cfg.execMode) {
     case ExecMode::CUDA: {
 #ifdef MADRONA_CUDA_SUPPORT
@@ -312,13 +536,12 @@ Manager::Impl * Manager::Impl::init(
 
         std::vector<ImportedInstance> imported_instances;
 
-        sim_cfg.mergeAll = false;
-
         LoadResult load_result = {};
 
         auto imported_assets = loadGLB(
                 render_mgr,
-                mgr_cfg.glbPath,
+                mgr_cfg,
+                importTextureDim(mgr_cfg),
                 load_result);
 
         sim_cfg.importedInstances = (ImportedInstance *)cu::allocGPU(
@@ -345,6 +568,13 @@ Manager::Impl * Manager::Impl::init(
                     load_result.uniqueSceneInfos.size(),
                     cudaMemcpyHostToDevice));
 
+        if (camera_trajectory) {
+            void *poses = cu::allocGPU(camera_trajectory->numPoseBytes());
+            REQ_CUDA(cudaMemcpy(poses, camera_trajectory->poses(),
+                        camera_trajectory->numPoseBytes(),
+                        cudaMemcpyHostToDevice));
+            sim_cfg.trajectoryPoses = (const TrajectoryPose *)poses;
+        }
 
         if (render_mgr.has_value()) {
             sim_cfg.renderBridge = render_mgr->bridge();
@@ -385,10 +615,10 @@ Manager::Impl * Manager::Impl::init(
             madrona::CudaBatchRenderConfig {
                 .renderMode = rt_render_mode,
                 // .importedAssets = &imported_assets,
-                .geoBVHData = render::AssetProcessor::makeBVHData(imported_assets.objects),
+                .geoBVHData = render::AssetProcessor::makeBVHData(imported_assets.objects()),
                 .materialData = render::AssetProcessor::initMaterialData(
-                        imported_assets.materials.data(), imported_assets.materials.size(),
-                        imported_assets.textures.data(), imported_assets.textures.size()),
+                        imported_assets.materials().data(), imported_assets.materials().size(),
+                        imported_assets.textures().data(), imported_assets.textures().size()),
                 .renderResolution = raycast_output_resolution,
                 .nearPlane = 3.f,
                 .farPlane = 1000.f
@@ -425,12 +655,71 @@ Manager::Impl * Manager::Impl::init(
 #endif
     } break;
     case ExecMode::CPU: {
-        FATAL("This environment doesn't support CPU backend");
+        Optional<RenderGPUState> render_gpu_state =
+            initRenderGPUState(mgr_cfg);
+
+        Optional<render::RenderManager> render_mgr =
+            initRenderManager(mgr_cfg, render_gpu_state);
+
+        LoadResult load_result = {};
+
+        // There is no raycaster on the CPU backend, so the imported assets
+        // are only needed by the render manager.
+        loadGLB(render_mgr, mgr_cfg,
+                importTextureDim(mgr_cfg), load_result);
+
+        sim_cfg.importedInstances = load_result.importedInstances.data();
+        sim_cfg.numImportedInstances = load_result.importedInstances.size();
+
+        sim_cfg.numUniqueScenes = load_result.uniqueSceneInfos.size();
+        sim_cfg.uniqueScenes = load_result.uniqueSceneInfos.data();
+
+        sim_cfg.numWorlds = mgr_cfg.numWorlds;
+
+        if (render_mgr.has_value()) {
+            sim_cfg.renderBridge = render_mgr->bridge();
+        } else {
+            sim_cfg.renderBridge = nullptr;
+        }
+
+        HeapArray<Sim::WorldInit> world_inits(mgr_cfg.numWorlds);
+
+        CPUImpl::TaskGraphT cpu_exec {
+            ThreadPoolExecutor::Config {
+                .numWorlds = mgr_cfg.numWorlds,
+                .numExportedBuffers = (uint32_t)ExportID::NumExports,
+            },
+            sim_cfg,
+            world_inits.data(),
+            (uint32_t)TaskGraphID::NumTaskGraphs,
+        };
+
+        Action *agent_actions_buffer =
+            (Action *)cpu_exec.getExported((uint32_t)ExportID::Action);
+
+        return new CPUImpl {
+            mgr_cfg,
+            agent_actions_buffer,
+            std::move(render_gpu_state),
+            std::move(render_mgr),
+            std::move(load_result),
+            std::move(camera_trajectory),
+            std::move(cpu_exec),
+        };
     } break;
     default: MADRONA_UNREACHABLE();
     }
 }
 
+uint32_t Manager::numGLBInstances(const Config &cfg)
+{
+    if (cfg.glbRandomInstances > 0) {
+        return cfg.glbRandomInstances;
+    }
+
+    return cfg.glbGridWidth * cfg.glbGridHeight;
+}
+
 Manager::Manager(const Config &cfg)
     : impl_(Impl::init(cfg))
 {
@@ -450,6 +739,8 @@ Manager::Manager(const Config &cfg)
         numAgents = 1;
     }
     
+    impl_->initWorlds();
+
     step();
 }
 
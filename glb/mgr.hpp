@@ -29,6 +29,15 @@ public:
         uint32_t raycastOutputResolution = 64;
         bool headlessMode = false;
         std::string glbPath;
+
+        // Copies of the GLB per world, for instance scaling benchmarks: a
+        // glbGridWidth x glbGridHeight grid glbInstanceSpacing apart, or
+        // glbRandomInstances random placements (seeded by randSeed) at the
+        // same density when non-zero.
+        uint32_t glbGridWidth = 1;
+        uint32_t glbGridHeight = 1;
+        uint32_t glbRandomInstances = 0;
+        float glbInstanceSpacing = 20.f;
     };
 
     Manager(const Config &cfg);
@@ -59,6 +68,9 @@ public:
 
     madrona::render::RenderManager & getRenderManager();
 
+    // GLB copies per world, not counting the ground plane
+    static uint32_t numGLBInstances(const Config &cfg);
+
     uint32_t numAgents;
 
 private:
@@ -47,8 +47,10 @@ void Sim::registerTypes(ECSRegistry &registry, const Config &cfg)
 
     registry.registerComponent<Action>();
     registry.registerComponent<AgentCamera>();
+    registry.registerComponent<InstanceSpawnRange>();
     registry.registerArchetype<Agent>();
     registry.registerArchetype<DummyRenderable>();
+    registry.registerArchetype<InstanceSpawner>();
     registry.registerSingleton<TimeSingleton>();
 
     registry.exportColumn<Agent, Action>(
@@ -67,6 +69,24 @@ inline void movementSystem(Engine &ctx,
                            Position &pos,
                            AgentCamera& cam)
 {
+    const Sim &sim = ctx.data();
+
+    // Scripted cameras ignore actions and the dynamic movement. The world
+    // has a single agent, which replays the trajectory's first view.
+    if (sim.trajectory != nullptr) {
+        const TrajectoryPose &pose = sim.trajectory[sim.trajectoryStep];
+
+        cam.yaw = pose.yaw;
+        cam.pitch = pose.pitch;
+
+        pos = pose.position;
+        pos.x += sim.worldCenter.x;
+        pos.y += sim.worldCenter.y;
+
+        rot = eulerToQuat(cam.yaw, cam.pitch);
+        return;
+    }
+
     Quat cur_rot = eulerToQuat(cam.yaw, 0);
     
     int actionX = action.x - 1;
@@ -132,10 +152,44 @@ inline void movementSystem(Engine &ctx,
     rot = eulerToQuat(cam.yaw, cam.pitch);
 }
 
+// Creates the renderable entities for one chunk of the world's imported
+// instances, writing the columns straight through the new entity's location.
+// Entities are still made and registered with the renderer one at a time;
+// reserving rows and copying whole columns would need a bulk creation API
+// in madrona.
+inline void spawnInstancesSystem(Engine &ctx,
+                                 const InstanceSpawnRange &range)
+{
+    const ImportedInstance *instances = ctx.data().importedInstances;
+
+    for (uint32_t i = range.begin; i < range.end; i++) {
+        const ImportedInstance &imp_inst = instances[i];
+
+        Entity e_inst = ctx.makeEntity<DummyRenderable>();
+        Loc loc = ctx.loc(e_inst);
+
+        ctx.getDirect<Position>(DummyRenderableCols::Position, loc) =
+            imp_inst.position;
+        ctx.getDirect<Rotation>(DummyRenderableCols::Rotation, loc) =
+            imp_inst.rotation;
+        ctx.getDirect<Scale>(DummyRenderableCols::Scale, loc) =
+            imp_inst.scale;
+        ctx.getDirect<ObjectID>(DummyRenderableCols::ObjectID, loc).idx =
+            imp_inst.objectID;
+
+        render::RenderingSystem::makeEntityRenderable(ctx, e_inst);
+    }
+}
+
 inline void timeUpdateSys(Engine &ctx,
                           TimeSingleton &time_single)
 {
     time_single.currentTime += 0.05f;
+
+    Sim &sim = ctx.data();
+    if (sim.trajectory != nullptr) {
+        sim.trajectoryStep = (sim.trajectoryStep + 1) % sim.trajectoryLen;
+    }
 }
 
 #ifdef MADRONA_GPU_MODE
@@ -153,6 +207,21 @@ TaskGraph::NodeID queueSortByWorld(TaskGraph::Builder &builder,
 }
 #endif
 
+static void setupInitTasks(TaskGraphBuilder &builder,
+                           const Sim::Config &cfg)
+{
+    auto spawn_sys = builder.addToGraph<ParallelForNode<Engine,
+        spawnInstancesSystem,
+            InstanceSpawnRange
+        >>({});
+
+    auto clear_spawners = builder.addToGraph<ClearTmpNode<InstanceSpawner>>(
+        {spawn_sys});
+
+    auto clear_tmp = builder.addToGraph<ResetTmpAllocNode>({clear_spawners});
+    (void)clear_tmp;
+}
+
 static void setupStepTasks(TaskGraphBuilder &builder, 
                            const Sim::Config &cfg)
 {
@@ -199,22 +268,22 @@ static void setupRenderTasks(TaskGraphBuilder &builder,
 // Build the task graph
 void Sim::setupTasks(TaskGraphManager &taskgraph_mgr, const Config &cfg)
 {
+    setupInitTasks(taskgraph_mgr.init(TaskGraphID::Init), cfg);
     setupStepTasks(taskgraph_mgr.init(TaskGraphID::Step), cfg);
     setupRenderTasks(taskgraph_mgr.init(TaskGraphID::Render), cfg);
 }
 
 static void loadInstances(Engine &ctx)
 {
-    for (int i = 0; i < (int)ctx.data().numImportedInstances; ++i) {
-        ImportedInstance *imp_inst = &ctx.data().importedInstances[i];
-
-        Entity e_inst = ctx.makeEntity<DummyRenderable>();
-        ctx.get<Position>(e_inst) = imp_inst->position;
-        ctx.get<Rotation>(e_inst) = imp_inst->rotation;
-        ctx.get<Scale>(e_inst) = imp_inst->scale;
-        ctx.get<ObjectID>(e_inst).idx = imp_inst->objectID;
-
-        render::RenderingSystem::makeEntityRenderable(ctx, e_inst);
+    // The instances themselves are created by the Init graph, split into
+    // chunks so large scenes aren't spawned by a single thread per world.
+    uint32_t num_instances = ctx.data().numImportedInstances;
+    for (uint32_t i = 0; i < num_instances; i += consts::instancesPerSpawner) {
+        Loc loc = ctx.makeTemporary<InstanceSpawner>();
+        ctx.getDirect<InstanceSpawnRange>(InstanceSpawnerCols::Range, loc) = {
+            .begin = i,
+            .end = std::min(i + consts::instancesPerSpawner, num_instances),
+        };
     }
 
     { // Create the agent entity of this world
@@ -265,6 +334,17 @@ Sim::Sim(Engine &ctx,
 
     worldCenter = { unique_scene->center.x, unique_scene->center.y };
 
+    if (cfg.trajectoryPoses != nullptr) {
+        uint32_t trajectory_idx =
+            (uint32_t)ctx.worldID().idx % cfg.numTrajectories;
+        trajectory = cfg.trajectoryPoses + (uint64_t)trajectory_idx *
+            cfg.trajectoryViews * cfg.trajectoryLen;
+    } else {
+        trajectory = nullptr;
+    }
+    trajectoryLen = cfg.trajectoryLen;
+    trajectoryStep = 0;
+
     RenderingSystem::init(ctx, cfg.renderBridge);
 
     loadInstances(ctx);
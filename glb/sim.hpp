@@ -1,7 +1,5 @@
 #pragma once
 
-// #define MERGE_ALL
-
 #include <madrona/taskgraph_builder.hpp>
 #include <madrona/custom_context.hpp>
 #include <madrona/rand.hpp>
@@ -31,6 +29,7 @@ struct ImportedInstance {
 };
 
 enum class TaskGraphID : uint32_t {
+    Init,
     Step,
     Render,
     NumTaskGraphs,
@@ -76,7 +75,13 @@ struct Sim : public madrona::WorldBase {
 
         uint32_t numAgents;
 
-        bool mergeAll;
+        // Optional camera trajectories replayed instead of movement:
+        // numTrajectories * trajectoryViews * trajectoryLen poses laid out
+        // [trajectory][view][step], null if there are none
+        const TrajectoryPose *trajectoryPoses;
+        uint32_t numTrajectories;
+        uint32_t trajectoryViews;
+        uint32_t trajectoryLen;
     };
 
     struct WorldInit {};
@@ -99,6 +104,11 @@ struct Sim : public madrona::WorldBase {
 
     madrona::math::Vector2 worldCenter;
 
+    // This world's trajectory (trajectoryLen poses per view), or null
+    const TrajectoryPose *trajectory;
+    uint32_t trajectoryLen;
+    uint32_t trajectoryStep;
+
     madrona::Entity agent;
 };
 
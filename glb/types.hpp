@@ -5,6 +5,7 @@
 #include <madrona/rand.hpp>
 #include <madrona/render/ecs.hpp>
 
+#include "archetype_column.hpp"
 #include "consts.hpp"
 
 namespace madEscape {
@@ -37,6 +38,14 @@ struct AgentCamera {
     float pitch;
 };
 
+// One camera pose of a precomputed trajectory (run::CameraTrajectory),
+// positioned relative to the scene center
+struct TrajectoryPose {
+    madrona::math::Vector3 position;
+    float yaw;
+    float pitch;
+};
+
 // Entity that is attached to the camera
 struct Agent : public madrona::Archetype<
     Position,
@@ -56,4 +65,32 @@ struct DummyRenderable : public madrona::Archetype<
     madrona::render::Renderable
  > {};
 
+// Column indices for direct writes
+namespace DummyRenderableCols {
+inline constexpr int32_t Position =
+    run::archetypeColumn<DummyRenderable, madrona::base::Position>;
+inline constexpr int32_t Rotation =
+    run::archetypeColumn<DummyRenderable, madrona::base::Rotation>;
+inline constexpr int32_t Scale =
+    run::archetypeColumn<DummyRenderable, madrona::base::Scale>;
+inline constexpr int32_t ObjectID =
+    run::archetypeColumn<DummyRenderable, madrona::base::ObjectID>;
+}
+
+// Range of the world's imported instances one init task spawns
+struct InstanceSpawnRange {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// Temporary, cleared once the instances are spawned
+struct InstanceSpawner : public madrona::Archetype<
+    InstanceSpawnRange
+> {};
+
+namespace InstanceSpawnerCols {
+inline constexpr int32_t Range =
+    run::archetypeColumn<InstanceSpawner, InstanceSpawnRange>;
+}
+
 }
@@ -0,0 +1,61 @@
+#include "mgr.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Prebuilds the baked asset cache for a set of scenes, so the first
+// viewer / headless run over a dataset starts as fast as later ones.
+// Scene selection follows the same rules as the Manager
+// (MADRONA_SEED, MADRONA_PROC_THOR, HABITAT_MERGE_ALL). VIEW_RES must
+// match the batch view size of later runs, since textures are imported at
+// a matching size.
+int main(int argc, char *argv[])
+{
+    using namespace madEscape;
+
+    bool bake_all = argc > 1 && !strcmp(argv[1], "--all");
+
+    if (bake_all) {
+        // Loads every scene in the dataset, bakes and exits
+        setenv("MADRONA_CACHE_ALL_BVH", "1", 1);
+    }
+
+    if (argc > 4 || (bake_all && argc > 3)) {
+        fprintf(stderr,
+                "%s [FIRST_SCENE] [NUM_SCENES] [VIEW_RES] | --all [VIEW_RES]\n",
+                argv[0]);
+        return 1;
+    }
+
+    setenv("MADRONA_ASSET_CACHE", "1", 1);
+
+    uint32_t first_scene = 0;
+    uint32_t num_scenes = 1;
+    uint32_t view_resolution = 64;
+
+    if (bake_all) {
+        if (argc > 2) {
+            view_resolution = (uint32_t)std::stoi(argv[2]);
+        }
+    } else {
+        if (argc > 1) {
+            first_scene = (uint32_t)std::stoi(argv[1]);
+        }
+
+        if (argc > 2) {
+            num_scenes = (uint32_t)std::stoi(argv[2]);
+        }
+
+        if (argc > 3) {
+            view_resolution = (uint32_t)std::stoi(argv[3]);
+        }
+    }
+
+    const char *merge_all_str = getenv("HABITAT_MERGE_ALL");
+    bool merge_static = merge_all_str && merge_all_str[0] == '1';
+
+    Manager::bakeAssets(first_scene, num_scenes, view_resolution,
+                        merge_static);
+}
@@ -3,11 +3,13 @@
 #include "dump.hpp"
 
 #include <cstdio>
+#include <cstdlib>
 #include <chrono>
 #include <string>
 #include <filesystem>
 #include <fstream>
 #include <random>
+#include <thread>
 
 #include <stb_image_write.h>
 #include <madrona/window.hpp>
@@ -34,7 +36,8 @@ int main(int argc, char *argv[])
 
     run::HeadlessRunArgs args = run::parseHeadlessArgs(argc, argv);
 
-    ExecMode exec_mode = ExecMode::CUDA;
+    ExecMode exec_mode = args.execBackend == run::ExecBackend::CPU ?
+        ExecMode::CPU : ExecMode::CUDA;
     uint64_t num_worlds = args.numWorlds;
     uint64_t num_steps = args.numSteps;
 
@@ -43,38 +46,116 @@ int main(int argc, char *argv[])
 
     uint32_t output_resolution = args.batchRenderWidth;
 
-    Manager mgr({
-        .execMode = exec_mode,
-        .gpuID = 0,
-        .numWorlds = (uint32_t)num_worlds,
-        .autoReset = false,
-        .enableBatchRenderer = enable_batch_renderer,
-        .batchRenderViewWidth = output_resolution,
-        .batchRenderViewHeight = output_resolution,
-        .raycastOutputResolution = output_resolution,
-        .headlessMode = true
-    });
-
-    auto start = std::chrono::system_clock::now();
-
-    for (CountT i = 0; i < (CountT)num_steps; i++) {
-        mgr.step();
+    const char *merge_all_str = getenv("HABITAT_MERGE_ALL");
+    bool merge_static = merge_all_str && merge_all_str[0] == '1';
+
+    const char *auto_reset_str = getenv("HABITAT_AUTO_RESET");
+    bool auto_reset = auto_reset_str && auto_reset_str[0] == '1';
+
+    // HSSD_SCENE_WINDOWS=N runs N consecutive windows of the scene range
+    // selected by HSSD_FIRST_SCENE / HSSD_NUM_SCENES (which, as in the
+    // Manager, is the end of the range) sequentially. Each window creates a
+    // new Manager; the next window is pre-baked into the asset cache on a
+    // background thread while the current Manager initializes, so its
+    // Manager only has to map the baked scenes. The bake is joined before
+    // the steps are timed, so it doesn't compete with the executor.
+    uint32_t num_windows = 1;
+    if (const char *windows_str = getenv("HSSD_SCENE_WINDOWS")) {
+        num_windows = (uint32_t)std::stoi(windows_str);
     }
 
-    if (args.dumpOutputFile) {
-        run::dumpTiledImage({
-            .outputPath = args.outputFileName,
-            .gpuTensor = (void *)mgr.raycastTensor().devicePtr(),
-            .numImages = (uint32_t)num_worlds,
-            .imageResolution = output_resolution
-        });
+    uint32_t first_scene = 0;
+    if (const char *first_str = getenv("HSSD_FIRST_SCENE")) {
+        first_scene = (uint32_t)std::stoi(first_str);
     }
 
-    auto end = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    uint32_t end_scene = 1;
+    if (const char *end_str = getenv("HSSD_NUM_SCENES")) {
+        end_scene = (uint32_t)std::stoi(end_str);
+    }
 
-    float fps = (double)num_steps * (double)num_worlds / elapsed.count();
-    printf("FPS %f\n", fps);
-    printf("Average total step time: %f ms\n",
-           1000.0f * elapsed.count() / (double)num_steps);
+    uint32_t window_size = end_scene > first_scene ?
+        end_scene - first_scene : 1;
+
+    for (uint32_t window = 0; window < num_windows; window++) {
+        uint32_t window_first = first_scene + window * window_size;
+
+        if (num_windows > 1) {
+            setenv("HSSD_FIRST_SCENE",
+                   std::to_string(window_first).c_str(), 1);
+            setenv("HSSD_NUM_SCENES",
+                   std::to_string(window_first + window_size).c_str(), 1);
+
+            printf("Scene window %u: scenes [%u, %u)\n", window,
+                   window_first, window_first + window_size);
+        }
+
+        std::thread prefetch;
+        if (window + 1 < num_windows) {
+            uint32_t next_first = window_first + window_size;
+            prefetch = std::thread([=]() {
+                Manager::bakeAssets(next_first, next_first + window_size,
+                                    output_resolution, merge_static);
+            });
+        }
+
+        auto init_start = std::chrono::system_clock::now();
+
+        Manager mgr({
+            .execMode = exec_mode,
+            .gpuID = 0,
+            .numWorlds = (uint32_t)num_worlds,
+            .autoReset = auto_reset,
+            .enableBatchRenderer = enable_batch_renderer,
+            .batchRenderViewWidth = output_resolution,
+            .batchRenderViewHeight = output_resolution,
+            .raycastOutputResolution = output_resolution,
+            .headlessMode = true,
+            .mergeStaticInstances = merge_static,
+        });
+
+        std::chrono::duration<double> init_elapsed =
+            std::chrono::system_clock::now() - init_start;
+        printf("Init time: %f s\n", init_elapsed.count());
+
+        if (prefetch.joinable()) {
+            auto join_start = std::chrono::system_clock::now();
+            prefetch.join();
+
+            std::chrono::duration<double> join_elapsed =
+                std::chrono::system_clock::now() - join_start;
+            printf("Waited %f s for the next window's bake\n",
+                   join_elapsed.count());
+        }
+
+        auto start = std::chrono::system_clock::now();
+
+        for (CountT i = 0; i < (CountT)num_steps; i++) {
+            mgr.step();
+        }
+
+        auto end = std::chrono::system_clock::now();
+
+        if (window + 1 == num_windows) {
+            if (args.dumpOutputFile && exec_mode == ExecMode::CPU) {
+                fprintf(stderr, "--dump-last-frame needs the raycaster, which is CUDA only\n");
+            } else if (args.dumpOutputFile) {
+                run::dumpTiledImage({
+                    .outputPath = args.outputFileName,
+                    .gpuTensor = (void *)mgr.raycastTensor().devicePtr(),
+                    .numImages = (uint32_t)num_worlds * mgr.numAgents,
+                    .imageResolution = output_resolution
+                });
+            }
+        }
+
+        std::chrono::duration<double> elapsed = end - start;
+
+        float fps = (double)num_steps * (double)num_worlds / elapsed.count();
+        printf("FPS %f\n", fps);
+        printf("Views per second (%u per world): %f\n", mgr.numAgents,
+               fps * (float)mgr.numAgents);
+        printf("Average total step time: %f ms\n",
+               1000.0f * elapsed.count() / (double)num_steps);
+    }
 }
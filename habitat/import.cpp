@@ -1,3 +1,4 @@
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <simdjson.h>
@@ -14,12 +15,251 @@ std::string convertPath(std::string path){
     return path.substr(index);
 }
 
-Scene habitatJSONLoad(std::string_view scene_path_name)
+// Parsers are reused across scenes loaded on the same thread. Scene files
+// and template configs need separate parsers because a scene's DOM stays
+// alive while its templates are being parsed.
+static simdjson::dom::parser & sceneParser()
+{
+    static thread_local simdjson::dom::parser parser;
+    return parser;
+}
+
+static simdjson::dom::parser & templateParser()
+{
+    static thread_local simdjson::dom::parser parser;
+    return parser;
+}
+
+uint32_t StringTable::intern(std::string_view str)
+{
+    auto iter = lookup_.find(str);
+    if (iter != lookup_.end()) {
+        return iter->second;
+    }
+
+    char *dst;
+    if (str.size() > chunkBytes) {
+        // Oversized strings get a chunk of their own
+        chunks_.emplace_back(new char[str.size()]);
+        dst = chunks_.back().get();
+        chunkOffset_ = chunkBytes;
+    } else {
+        if (chunks_.empty() || chunkOffset_ + str.size() > chunkBytes) {
+            chunks_.emplace_back(new char[chunkBytes]);
+            chunkOffset_ = 0;
+        }
+
+        dst = chunks_.back().get() + chunkOffset_;
+        chunkOffset_ += str.size();
+    }
+
+    memcpy(dst, str.data(), str.size());
+
+    uint32_t idx = (uint32_t)strings_.size();
+    strings_.emplace_back(dst, str.size());
+    lookup_.emplace(strings_.back(), idx);
+
+    return idx;
+}
+
+std::string_view StringTable::get(uint32_t idx) const
+{
+    return strings_[idx];
+}
+
+uint32_t StringTable::size() const
+{
+    return (uint32_t)strings_.size();
+}
+
+const TemplateConfig & TemplateCache::get(
+    const std::filesystem::path &config_path)
+{
+    std::string key = config_path.string();
+
+    {
+        std::lock_guard lock(lock_);
+        auto iter = configs_.find(key);
+        if (iter != configs_.end()) {
+            return *iter->second;
+        }
+    }
+
+    // Parse outside the lock so threads loading different templates don't
+    // serialize on each other. If two threads race on the same template,
+    // the first insertion wins.
+    auto config = std::make_unique<TemplateConfig>();
+    try {
+        simdjson::dom::element root = templateParser().load(key);
+        config->renderAsset = string(string_view(root["render_asset"]));
+
+        simdjson::dom::array front_obj;
+        config->hasFront = !root.at_key("front").get(front_obj);
+        if (config->hasFront) {
+            uint32_t front_idx = 0;
+            for (auto c : front_obj) {
+                config->front[front_idx++] = float(double(c));
+            }
+        }
+    } catch (const simdjson::simdjson_error &e) {
+        cerr << "Habitat JSON loading '" << key
+             << "' failed: " << e.what() << endl;
+        abort();
+    }
+
+    std::lock_guard lock(lock_);
+    auto [iter, inserted] = configs_.emplace(std::move(key), std::move(config));
+    return *iter->second;
+}
+
+std::vector<std::string> TemplateCache::paths()
+{
+    std::lock_guard lock(lock_);
+
+    std::vector<std::string> config_paths;
+    config_paths.reserve(configs_.size());
+    for (const auto &[config_path, config] : configs_) {
+        config_paths.push_back(config_path);
+    }
+
+    return config_paths;
+}
+
+static void loadStageConfig(TemplateCache &template_cache,
+                            const filesystem::path &stage_path,
+                            const filesystem::path &stage_dir,
+                            Scene &scene)
+{
+    const TemplateConfig &stage_cfg = template_cache.get(stage_path);
+    if (!stage_cfg.hasFront) {
+        cerr << "Habitat JSON loading '" << stage_path
+             << "' failed: missing front" << endl;
+        abort();
+    }
+
+    scene.stagePath = stage_dir / stage_cfg.renderAsset;
+    for (int i = 0; i < 3; i++) {
+        scene.stageFront[i] = stage_cfg.front[i];
+    }
+}
+
+static filesystem::path resolveHSSDObject(
+    const filesystem::path &root_path,
+    string_view template_name,
+    TemplateCache &template_cache,
+    const ObjectManifest *manifest)
+{
+    using namespace filesystem;
+
+    string_view indexed_asset =
+        manifest ? manifest->find(template_name) : string_view();
+    if (!indexed_asset.empty()) {
+        return root_path / indexed_asset;
+    }
+
+    path object_glb_path = root_path / "objects";
+    path object_config_path = root_path / "objects";
+
+    bool is_decomposed = false;
+
+    if (template_name.length() > 10) {
+        auto part_start = template_name.find("part");
+
+        if (part_start != std::string::npos) {
+            is_decomposed = true;
+            string core_name = string(template_name);
+            core_name.resize(part_start - 1);
+            object_glb_path = object_glb_path / "decomposed";
+            object_glb_path = object_glb_path / core_name;
+            object_glb_path = object_glb_path / template_name;
+            object_glb_path.concat(".glb");
+
+            object_config_path = object_config_path / string(1, template_name[0]);
+            object_config_path = object_config_path / core_name;
+            object_config_path.concat(".object_config.json");
+        }
+        else {
+            object_config_path = object_config_path / string(1, template_name[0]);
+            object_config_path = object_config_path / template_name;
+            object_config_path.concat(".object_config.json");
+
+            object_glb_path = object_glb_path / string(1, template_name[0]);
+            object_glb_path = object_glb_path / template_name;
+            object_glb_path.concat(".glb");
+        }
+    } else {
+        object_config_path = object_config_path / "openings";
+        object_config_path = object_config_path / template_name;
+        object_config_path.concat(".object_config.json");
+
+        object_glb_path = object_glb_path / "openings";
+        object_glb_path = object_glb_path / template_name;
+        object_glb_path.concat(".object_config.json");
+    }
+
+    // The GLB path is derived from the template name, but the config is
+    // still loaded so a missing template fails loudly.
+    template_cache.get(object_config_path);
+
+    return object_glb_path;
+}
+
+static filesystem::path resolveProcThorObject(
+    string_view obj_root_paths,
+    string_view template_name,
+    TemplateCache &template_cache,
+    const ObjectManifest *manifest)
+{
+    using namespace filesystem;
+
+    string_view indexed_asset =
+        manifest ? manifest->find(template_name) : string_view();
+    if (!indexed_asset.empty()) {
+        return path(obj_root_paths) / indexed_asset;
+    }
+
+    path object_config_path = obj_root_paths;
+    object_config_path = object_config_path / template_name;
+    object_config_path.concat(".object_config.json");
+
+    const TemplateConfig &inst_cfg = template_cache.get(object_config_path);
+    return path(obj_root_paths) / "objects" / inst_cfg.renderAsset;
+}
+
+// Instances of the same template share their path, so it is resolved and
+// interned once per template and scene. template_paths maps name indices
+// to path indices.
+template <typename ResolveFn>
+static uint32_t templatePath(Scene &scene,
+                             vector<uint32_t> &template_paths,
+                             uint32_t name_idx,
+                             ResolveFn &&resolve)
+{
+    if (name_idx >= template_paths.size()) {
+        template_paths.resize(name_idx + 1, ~0u);
+    }
+
+    if (template_paths[name_idx] == ~0u) {
+        filesystem::path resolved = resolve();
+        template_paths[name_idx] = scene.strings.intern(resolved.native());
+    }
+
+    return template_paths[name_idx];
+}
+
+Scene habitatJSONLoad(std::string_view scene_path_name,
+                      TemplateCache *template_cache,
+                      const ObjectManifest *manifest)
 {
     using namespace filesystem;
     using namespace simdjson;
     using namespace HabitatJSON;
 
+    TemplateCache scene_template_cache;
+    if (template_cache == nullptr) {
+        template_cache = &scene_template_cache;
+    }
+
     path scene_path(absolute(scene_path_name));
     path root_path = scene_path.parent_path().parent_path();
 
@@ -28,25 +268,14 @@ Scene habitatJSONLoad(std::string_view scene_path_name)
     Scene scene;
 
     try {
-        simdjson::dom::parser scene_parser;
-        simdjson::dom::element root = scene_parser.load(scene_path);
+        simdjson::dom::element root = sceneParser().load(scene_path);
 
         string_view stage_name = root["stage_instance"]["template_name"];
 
         auto stage_path = root_path / stage_name;
         stage_path.concat(".stage_config.json");
 
-        simdjson::dom::parser stage_parser;
-        auto stage_root = stage_parser.load(stage_path);
-        string_view render_asset_name = stage_root["render_asset"];
-        scene.stagePath = 
-            stage_dir / render_asset_name;
-
-        uint32_t front_idx = 0;
-        auto front_obj = stage_root["front"];
-        for (auto c : front_obj) {
-            scene.stageFront[front_idx++] = float(double(c));
-        }
+        loadStageConfig(*template_cache, stage_path, stage_dir, scene);
 
 #if 0
         string_view lighting_path_str = string_view(root["default_lighting"]);
@@ -99,8 +328,10 @@ Scene habitatJSONLoad(std::string_view scene_path_name)
         }
 #endif
 
-        simdjson::dom::parser nested_parser;
-        auto insts = root["object_instances"];
+        simdjson::dom::array insts = root["object_instances"];
+        scene.additionalInstances.reserve(insts.size());
+
+        vector<uint32_t> template_paths;
 
         for (const auto &inst : insts) {
             AdditionalInstance additional_inst;
@@ -143,51 +374,12 @@ Scene habitatJSONLoad(std::string_view scene_path_name)
 
             string_view template_name = inst["template_name"];
 
-            path object_glb_path = root_path / "objects";
-            path object_config_path = root_path / "objects";
-
-            bool is_decomposed = false;
-
-            if (template_name.length() > 10) {
-                auto part_start = template_name.find("part");
-
-                if (part_start != std::string::npos) {
-                    is_decomposed = true;
-                    string core_name = string(template_name);
-                    core_name.resize(part_start - 1);
-                    object_glb_path = object_glb_path / "decomposed";
-                    object_glb_path = object_glb_path / core_name;
-                    object_glb_path = object_glb_path / template_name;
-                    object_glb_path.concat(".glb");
-
-                    object_config_path = object_config_path / string(1, template_name[0]);
-                    object_config_path = object_config_path / core_name;
-                    object_config_path.concat(".object_config.json");
-                }
-                else {
-                    object_config_path = object_config_path / string(1, template_name[0]);
-                    object_config_path = object_config_path / template_name;
-                    object_config_path.concat(".object_config.json");
-
-                    object_glb_path = object_glb_path / string(1, template_name[0]);
-                    object_glb_path = object_glb_path / template_name;
-                    object_glb_path.concat(".glb");
-                }
-            } else {
-                object_config_path = object_config_path / "openings";
-                object_config_path = object_config_path / template_name;
-                object_config_path.concat(".object_config.json");
-
-                object_glb_path = object_glb_path / "openings";
-                object_glb_path = object_glb_path / template_name;
-                object_glb_path.concat(".object_config.json");
-            }
-
-            auto inst_root = nested_parser.load(object_config_path);
-            string_view inst_asset = inst_root["render_asset"];
-
-            additional_inst.name = string(template_name);
-            additional_inst.gltfPath = object_glb_path;
+            additional_inst.name = scene.strings.intern(template_name);
+            additional_inst.gltfPath = templatePath(
+                scene, template_paths, additional_inst.name, [&]() {
+                    return resolveHSSDObject(root_path, template_name,
+                                             *template_cache, manifest);
+                });
             additional_inst.dynamic =
                 string_view(inst["motion_type"]) == "DYNAMIC";
 
@@ -201,13 +393,14 @@ Scene habitatJSONLoad(std::string_view scene_path_name)
                 string_view template_name = obj["template_name"];
                 auto template_path = root_path / template_name;
                 template_path.concat(".object_config.json");
-                auto obj_root = nested_parser.load(template_path);
-                string_view obj_asset = obj_root["render_asset"];
+                const TemplateConfig &obj_cfg =
+                    template_cache->get(template_path);
 
-                auto obj_path = template_path.parent_path() / obj_asset;
+                auto obj_path =
+                    template_path.parent_path() / obj_cfg.renderAsset;
                 scene.additionalObjects.push_back({
-                    string(obj["name"]),
-                    obj_path,
+                    scene.strings.intern(string_view(obj["name"])),
+                    scene.strings.intern(obj_path.native()),
                 });
             }
         }
@@ -222,12 +415,19 @@ Scene habitatJSONLoad(std::string_view scene_path_name)
 
 Scene procThorJSONLoad(std::string_view root_paths,
                        std::string_view obj_root_paths,
-                       std::string_view scene_path_name)
+                       std::string_view scene_path_name,
+                       TemplateCache *template_cache,
+                       const ObjectManifest *manifest)
 {
     using namespace filesystem;
     using namespace simdjson;
     using namespace HabitatJSON;
 
+    TemplateCache scene_template_cache;
+    if (template_cache == nullptr) {
+        template_cache = &scene_template_cache;
+    }
+
     path scene_path(absolute(scene_path_name));
     path root_path = root_paths;
 
@@ -236,24 +436,14 @@ Scene procThorJSONLoad(std::string_view root_paths,
     Scene scene;
 
     try {
-        simdjson::dom::parser scene_parser;
-        simdjson::dom::element root = scene_parser.load(scene_path);
+        simdjson::dom::element root = sceneParser().load(scene_path);
 
         string_view stage_name = root["stage_instance"]["template_name"];
         auto stage_path = root_path / stage_name;
         stage_path.concat(".stage_config.json");
 
-        simdjson::dom::parser stage_parser;
-        auto stage_root = stage_parser.load(stage_path);
-        string_view render_asset_name = stage_root["render_asset"];
-        scene.stagePath =
-            stage_path.parent_path() / render_asset_name;
-
-        uint32_t front_idx = 0;
-        auto front_obj = stage_root["front"];
-        for (auto c : front_obj) {
-            scene.stageFront[front_idx++] = float(double(c));
-        }
+        loadStageConfig(*template_cache, stage_path,
+                        stage_path.parent_path(), scene);
 
         string_view lighting_path_str;
 
@@ -309,8 +499,10 @@ Scene procThorJSONLoad(std::string_view root_paths,
             }
         }
 
-        simdjson::dom::parser nested_parser;
-        auto insts = root["object_instances"];
+        simdjson::dom::array insts = root["object_instances"];
+        scene.additionalInstances.reserve(insts.size());
+
+        vector<uint32_t> template_paths;
 
         for (const auto &inst : insts) {
             AdditionalInstance additional_inst;
@@ -353,17 +545,12 @@ Scene procThorJSONLoad(std::string_view root_paths,
 
             string_view template_name = inst["template_name"];
 
-            path object_glb_path = path(obj_root_paths) / "objects";
-            path object_config_path = obj_root_paths;
-            object_config_path = object_config_path / template_name;
-            object_config_path.concat(".object_config.json");
-
-            auto inst_root = nested_parser.load(object_config_path);
-            string_view inst_asset = inst_root["render_asset"];
-            object_glb_path = object_glb_path / inst_asset;
-
-            additional_inst.name = string(template_name);
-            additional_inst.gltfPath = object_glb_path;
+            additional_inst.name = scene.strings.intern(template_name);
+            additional_inst.gltfPath = templatePath(
+                scene, template_paths, additional_inst.name, [&]() {
+                    return resolveProcThorObject(obj_root_paths, template_name,
+                                                 *template_cache, manifest);
+                });
             additional_inst.dynamic =
                 string_view(inst["motion_type"]) == "DYNAMIC";
 
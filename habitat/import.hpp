@@ -1,8 +1,14 @@
 #pragma once
 
 #include <vector>
+#include <string>
 #include <string_view>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "manifest.hpp"
 
 namespace HabitatJSON {
     
@@ -18,9 +24,29 @@ struct Light {
     float color[3];
 };
 
+// Deduplicated strings backed by large chunks, referred to by index.
+// Scenes instance a few hundred templates thousands of times, so this
+// replaces two heap strings per instance with a few chunk allocations.
+class StringTable {
+public:
+    uint32_t intern(std::string_view str);
+    std::string_view get(uint32_t idx) const;
+    uint32_t size() const;
+
+private:
+    static constexpr size_t chunkBytes = 64 * 1024;
+
+    // Chunks never move, so the views below stay valid when the table does
+    std::vector<std::unique_ptr<char[]>> chunks_ {};
+    size_t chunkOffset_ = chunkBytes;
+    std::vector<std::string_view> strings_ {};
+    std::unordered_map<std::string_view, uint32_t> lookup_ {};
+};
+
+// name and gltfPath index Scene::strings
 struct AdditionalInstance {
-    std::string name;
-    std::filesystem::path gltfPath;
+    uint32_t name;
+    uint32_t gltfPath;
     float pos[3];
     float rotation[4];
     float scale[3];
@@ -28,22 +54,52 @@ struct AdditionalInstance {
 };
 
 struct AdditionalObject {
-    std::string name;
-    std::filesystem::path gltfPath;
+    uint32_t name;
+    uint32_t gltfPath;
 };
 
 struct Scene {
     std::filesystem::path stagePath;
     float stageFront[3];
+    StringTable strings;
     std::vector<AdditionalInstance> additionalInstances;
     std::vector<AdditionalObject> additionalObjects;
     std::vector<Light> lights;
 };
 
-Scene habitatJSONLoad(std::string_view scene_path_name);
+// Fields read from a *.object_config.json / *.stage_config.json template
+struct TemplateConfig {
+    std::string renderAsset;
+    bool hasFront;
+    float front[3];
+};
+
+// Parsed template configs keyed by path, so a template referenced by many
+// instances and scenes is only read from disk and parsed once. Can be
+// shared between threads loading different scenes.
+class TemplateCache {
+public:
+    const TemplateConfig & get(const std::filesystem::path &config_path);
+
+    // Every config read so far
+    std::vector<std::string> paths();
+
+private:
+    std::mutex lock_;
+    std::unordered_map<std::string, std::unique_ptr<TemplateConfig>> configs_;
+};
+
+// If template_cache is null, templates are only shared within the scene.
+// Instances found in manifest skip path derivation and their object
+// config; anything missing from it is resolved as if there was none.
+Scene habitatJSONLoad(std::string_view scene_path_name,
+                      TemplateCache *template_cache = nullptr,
+                      const ObjectManifest *manifest = nullptr);
 
 Scene procThorJSONLoad(std::string_view root_paths,
                        std::string_view obj_root_paths,
-                       std::string_view scene_path_name);
+                       std::string_view scene_path_name,
+                       TemplateCache *template_cache = nullptr,
+                       const ObjectManifest *manifest = nullptr);
 
 }
@@ -0,0 +1,284 @@
+#include "manifest.hpp"
+
+#include "asset_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace HabitatJSON {
+
+namespace {
+
+// Bump when the layout below changes.
+constexpr uint32_t manifestVersion = 1;
+constexpr char manifestMagic[8] = { 'M', 'A', 'D', 'M', 'A', 'N', 'I', 'F' };
+
+struct ManifestHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numSlots;
+    uint64_t key;
+    uint64_t totalBytes;
+    uint64_t slotsOffset;
+    uint64_t sceneFilesOffset;
+    uint64_t stringsOffset;
+    uint64_t numStringBytes;
+    uint32_t numSceneFiles;
+    uint32_t pad;
+};
+
+bool rangeInBounds(uint64_t offset, uint64_t num_bytes, uint64_t total)
+{
+    return offset <= total && num_bytes <= total - offset;
+}
+
+uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint64_t hashTemplateName(std::string_view name)
+{
+    return run::hashString(name, 0);
+}
+
+}
+
+// Slots with numKeyBytes == 0 are empty; template names never are.
+struct ObjectManifest::Slot {
+    uint64_t hash;
+    uint32_t keyOffset;
+    uint32_t numKeyBytes;
+    uint32_t valueOffset;
+    uint32_t numValueBytes;
+};
+
+struct ObjectManifest::StringRef {
+    uint32_t offset;
+    uint32_t numBytes;
+};
+
+ObjectManifest::ObjectManifest(void *mapping, size_t num_mapped_bytes)
+    : mapping_(mapping),
+      numMappedBytes_(num_mapped_bytes),
+      slots_(nullptr),
+      slotMask_(0),
+      sceneFiles_(nullptr),
+      numSceneFiles_(0),
+      strings_(nullptr)
+{}
+
+ObjectManifest::~ObjectManifest()
+{
+    munmap(mapping_, numMappedBytes_);
+}
+
+std::unique_ptr<ObjectManifest> ObjectManifest::load(
+    const std::filesystem::path &path, uint64_t key)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) != 0 ||
+            (size_t)stat_buf.st_size < sizeof(ManifestHeader)) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t num_bytes = (size_t)stat_buf.st_size;
+    void *mapping = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ObjectManifest> manifest(
+        new ObjectManifest(mapping, num_bytes));
+    const char *base = (const char *)mapping;
+
+    const ManifestHeader &hdr = *(const ManifestHeader *)base;
+    if (memcmp(hdr.magic, manifestMagic, sizeof(manifestMagic)) != 0 ||
+            hdr.version != manifestVersion ||
+            hdr.key != key ||
+            hdr.totalBytes != num_bytes ||
+            hdr.numSlots == 0 ||
+            (hdr.numSlots & (hdr.numSlots - 1)) != 0 ||
+            !rangeInBounds(hdr.slotsOffset,
+                sizeof(Slot) * (uint64_t)hdr.numSlots, num_bytes) ||
+            !rangeInBounds(hdr.sceneFilesOffset,
+                sizeof(StringRef) * (uint64_t)hdr.numSceneFiles, num_bytes) ||
+            !rangeInBounds(hdr.stringsOffset, hdr.numStringBytes, num_bytes)) {
+        fprintf(stderr, "Ignoring invalid object manifest %s\n",
+                path.c_str());
+        return nullptr;
+    }
+
+    manifest->slots_ = (const Slot *)(base + hdr.slotsOffset);
+    manifest->slotMask_ = hdr.numSlots - 1;
+    manifest->sceneFiles_ = (const StringRef *)(base + hdr.sceneFilesOffset);
+    manifest->numSceneFiles_ = hdr.numSceneFiles;
+    manifest->strings_ = base + hdr.stringsOffset;
+
+    // Validate every string once here, so lookups don't have to.
+    for (uint32_t i = 0; i < hdr.numSlots; i++) {
+        const Slot &slot = manifest->slots_[i];
+        if (!rangeInBounds(slot.keyOffset, slot.numKeyBytes,
+                           hdr.numStringBytes) ||
+                !rangeInBounds(slot.valueOffset, slot.numValueBytes,
+                               hdr.numStringBytes)) {
+            fprintf(stderr, "Ignoring invalid object manifest %s\n",
+                    path.c_str());
+            return nullptr;
+        }
+    }
+
+    for (uint32_t i = 0; i < hdr.numSceneFiles; i++) {
+        const StringRef &ref = manifest->sceneFiles_[i];
+        if (!rangeInBounds(ref.offset, ref.numBytes, hdr.numStringBytes)) {
+            fprintf(stderr, "Ignoring invalid object manifest %s\n",
+                    path.c_str());
+            return nullptr;
+        }
+    }
+
+    return manifest;
+}
+
+bool ObjectManifest::write(const std::filesystem::path &path,
+                           uint64_t key,
+                           const std::vector<ManifestEntry> &entries,
+                           const std::vector<std::string> &scene_files)
+{
+    // Keep the load factor at or below 1/2 so probe chains stay short
+    uint32_t num_slots = 16;
+    while (num_slots < entries.size() * 2) {
+        num_slots *= 2;
+    }
+
+    std::vector<char> strings;
+    auto appendString = [&strings](std::string_view str) {
+        uint32_t offset = (uint32_t)strings.size();
+        strings.insert(strings.end(), str.begin(), str.end());
+        return offset;
+    };
+
+    std::vector<Slot> slots(num_slots, Slot {});
+    for (const ManifestEntry &entry : entries) {
+        if (entry.templateName.empty()) {
+            continue;
+        }
+
+        uint64_t hash = hashTemplateName(entry.templateName);
+        uint32_t slot_idx = (uint32_t)hash & (num_slots - 1);
+
+        bool duplicate = false;
+        while (slots[slot_idx].numKeyBytes != 0) {
+            const Slot &slot = slots[slot_idx];
+            if (slot.hash == hash && std::string_view(
+                    strings.data() + slot.keyOffset, slot.numKeyBytes) ==
+                    entry.templateName) {
+                duplicate = true;
+                break;
+            }
+
+            slot_idx = (slot_idx + 1) & (num_slots - 1);
+        }
+
+        // The first resolution of a template wins
+        if (duplicate) {
+            continue;
+        }
+
+        Slot &slot = slots[slot_idx];
+        slot.hash = hash;
+        slot.keyOffset = appendString(entry.templateName);
+        slot.numKeyBytes = (uint32_t)entry.templateName.size();
+        slot.valueOffset = appendString(entry.renderAsset);
+        slot.numValueBytes = (uint32_t)entry.renderAsset.size();
+    }
+
+    std::vector<StringRef> scene_refs;
+    scene_refs.reserve(scene_files.size());
+    for (const std::string &file : scene_files) {
+        scene_refs.push_back({
+            .offset = appendString(file),
+            .numBytes = (uint32_t)file.size(),
+        });
+    }
+
+    ManifestHeader hdr {};
+    memcpy(hdr.magic, manifestMagic, sizeof(manifestMagic));
+    hdr.version = manifestVersion;
+    hdr.numSlots = num_slots;
+    hdr.key = key;
+    hdr.numSceneFiles = (uint32_t)scene_refs.size();
+    hdr.slotsOffset = alignOffset(sizeof(ManifestHeader), alignof(Slot));
+    hdr.sceneFilesOffset = alignOffset(
+        hdr.slotsOffset + sizeof(Slot) * slots.size(), alignof(StringRef));
+    hdr.stringsOffset =
+        hdr.sceneFilesOffset + sizeof(StringRef) * scene_refs.size();
+    hdr.numStringBytes = strings.size();
+    hdr.totalBytes = hdr.stringsOffset + hdr.numStringBytes;
+
+    std::vector<char> buf(hdr.totalBytes, 0);
+    memcpy(buf.data(), &hdr, sizeof(ManifestHeader));
+    memcpy(buf.data() + hdr.slotsOffset, slots.data(),
+           sizeof(Slot) * slots.size());
+    if (!scene_refs.empty()) {
+        memcpy(buf.data() + hdr.sceneFilesOffset, scene_refs.data(),
+               sizeof(StringRef) * scene_refs.size());
+    }
+    if (!strings.empty()) {
+        memcpy(buf.data() + hdr.stringsOffset, strings.data(),
+               strings.size());
+    }
+
+    return run::writeFileAtomic(path, buf.data(), buf.size(),
+                                "object manifest");
+}
+
+std::string_view ObjectManifest::find(std::string_view template_name) const
+{
+    uint64_t hash = hashTemplateName(template_name);
+
+    for (uint32_t slot_idx = (uint32_t)hash & slotMask_; ;
+         slot_idx = (slot_idx + 1) & slotMask_) {
+        const Slot &slot = slots_[slot_idx];
+        if (slot.numKeyBytes == 0) {
+            return {};
+        }
+
+        if (slot.hash == hash &&
+                str(slot.keyOffset, slot.numKeyBytes) == template_name) {
+            return str(slot.valueOffset, slot.numValueBytes);
+        }
+    }
+}
+
+uint32_t ObjectManifest::numSceneFiles() const
+{
+    return numSceneFiles_;
+}
+
+std::string_view ObjectManifest::sceneFile(uint32_t idx) const
+{
+    const StringRef &ref = sceneFiles_[idx];
+    return str(ref.offset, ref.numBytes);
+}
+
+std::string_view ObjectManifest::str(uint32_t offset,
+                                     uint32_t num_bytes) const
+{
+    return std::string_view(strings_ + offset, num_bytes);
+}
+
+}
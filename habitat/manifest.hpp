@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HabitatJSON {
+
+struct ManifestEntry {
+    std::string templateName;
+    // Render asset path, relative to the object root the scene loader
+    // resolves instances against.
+    std::string renderAsset;
+};
+
+// Template name -> render asset index for a whole dataset, plus the list of
+// scene files, built once by habitat_manifest. Scene loading looks
+// instances up here instead of deriving paths from template names and
+// reading object configs, and doesn't need to list the scene directory.
+//
+// The file is mapped read-only and holds an open addressing hash table
+// pointing into a string blob, so loading it doesn't parse or allocate
+// per entry.
+class ObjectManifest {
+public:
+    // Returns null if the file is missing, invalid or was built with a
+    // different key.
+    static std::unique_ptr<ObjectManifest> load(
+        const std::filesystem::path &path, uint64_t key);
+
+    static bool write(const std::filesystem::path &path,
+                      uint64_t key,
+                      const std::vector<ManifestEntry> &entries,
+                      const std::vector<std::string> &scene_files);
+
+    ObjectManifest(const ObjectManifest &) = delete;
+    ~ObjectManifest();
+
+    // Empty if template_name isn't indexed
+    std::string_view find(std::string_view template_name) const;
+
+    uint32_t numSceneFiles() const;
+    // File name within the scene directory
+    std::string_view sceneFile(uint32_t idx) const;
+
+private:
+    struct Slot;
+    struct StringRef;
+
+    ObjectManifest(void *mapping, size_t num_mapped_bytes);
+
+    std::string_view str(uint32_t offset, uint32_t num_bytes) const;
+
+    void *mapping_;
+    size_t numMappedBytes_;
+    const Slot *slots_;
+    uint32_t slotMask_;
+    const StringRef *sceneFiles_;
+    uint32_t numSceneFiles_;
+    const char *strings_;
+};
+
+}
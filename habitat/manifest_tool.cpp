@@ -0,0 +1,18 @@
+#include "mgr.hpp"
+
+#include <cstdio>
+
+// Builds the object manifest for the dataset selected by
+// MADRONA_PROC_THOR. Run once per dataset, and again after adding scenes
+// or changing object configs.
+int main(int argc, char *argv[])
+{
+    using namespace madEscape;
+
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s [scene options]\n", argv[0]);
+        return 1;
+    }
+
+    Manager::buildObjectManifest();
+}
@@ -1,6 +1,12 @@
 #include "mgr.hpp"
 #include "sim.hpp"
 #include "import.hpp"
+#include "parallel.hpp"
+#include "asset_cache.hpp"
+#include "asset_import.hpp"
+#include "ktx_import.hpp"
+#include "camera_trajectory.hpp"
+#include "scene_merge.hpp"
 
 #include <random>
 #include <numeric>
@@ -16,10 +22,12 @@
 
 #include <array>
 #include <charconv>
+#include <cstring>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <unordered_map>
 
 #include <madrona/render/asset_processor.hpp>
 
@@ -69,7 +77,8 @@ static inline Optional<RenderGPUState> initRenderGPUState(
 
 static inline Optional<render::RenderManager> initRenderManager(
     const Manager::Config &mgr_cfg,
-    const Optional<RenderGPUState> &render_gpu_state)
+    const Optional<RenderGPUState> &render_gpu_state,
+    uint32_t max_instances_per_world)
 {
     if (mgr_cfg.headlessMode && !mgr_cfg.enableBatchRenderer) {
         return Optional<render::RenderManager>::none();
@@ -99,15 +108,23 @@ static inline Optional<render::RenderManager> initRenderManager(
         .agentViewHeight = mgr_cfg.batchRenderViewHeight,
         .numWorlds = mgr_cfg.numWorlds,
         .maxViewsPerWorld = consts::maxAgents,
-        .maxInstancesPerWorld = 1024,
+        .maxInstancesPerWorld = max_instances_per_world,
         .execMode = mgr_cfg.execMode,
         .voxelCfg = {},
     });
 }
 
+struct LoadResult {
+    std::vector<ImportedInstance> importedInstances;
+    std::vector<UniqueScene> uniqueSceneInfos;
+};
+
 struct Manager::Impl {
     Config cfg;
     Action *agentActionsBuffer;
+    WorldReset *worldResetBuffer;
+    uint32_t *worldScenesBuffer;
+    uint32_t numLoadedScenes;
     Optional<RenderGPUState> renderGPUState;
     Optional<render::RenderManager> renderMgr;
     uint32_t raycastOutputResolution;
@@ -115,11 +132,17 @@ struct Manager::Impl {
 
     inline Impl(const Manager::Config &mgr_cfg,
                 Action *action_buffer,
+                WorldReset *reset_buffer,
+                uint32_t *world_scenes_buffer,
+                uint32_t num_loaded_scenes,
                 Optional<RenderGPUState> &&render_gpu_state,
                 Optional<render::RenderManager> &&render_mgr,
                 uint32_t raycast_output_resolution)
         : cfg(mgr_cfg),
           agentActionsBuffer(action_buffer),
+          worldResetBuffer(reset_buffer),
+          worldScenesBuffer(world_scenes_buffer),
+          numLoadedScenes(num_loaded_scenes),
           renderGPUState(std::move(render_gpu_state)),
           renderMgr(std::move(render_mgr)),
           raycastOutputResolution(raycast_output_resolution),
@@ -128,6 +151,9 @@ struct Manager::Impl {
 
     inline virtual ~Impl() {}
 
+    // Runs the Init graph once, after the worlds are constructed
+    virtual void initWorlds() = 0;
+
     virtual void run() = 0;
 
     virtual Tensor exportTensor(ExportID slot,
@@ -137,6 +163,63 @@ struct Manager::Impl {
     static inline Impl * init(const Config &cfg);
 };
 
+struct Manager::CPUImpl final : Manager::Impl {
+    using TaskGraphT =
+        TaskGraphExecutor<Engine, Sim, Sim::Config, Sim::WorldInit>;
+
+    // Sim::Config points into these, so they live as long as the worlds
+    LoadResult loadResult;
+    std::vector<Entity> instanceEntities;
+    std::vector<uint32_t> worldScenes;
+    std::unique_ptr<run::CameraTrajectory> cameraTrajectory;
+    TaskGraphT cpuExec;
+
+    inline CPUImpl(const Manager::Config &mgr_cfg,
+                   Action *action_buffer,
+                   WorldReset *reset_buffer,
+                   Optional<RenderGPUState> &&render_gpu_state,
+                   Optional<render::RenderManager> &&render_mgr,
+                   LoadResult &&load_result,
+                   std::vector<Entity> &&instance_entities,
+                   std::vector<uint32_t> &&world_scenes,
+                   std::unique_ptr<run::CameraTrajectory> &&camera_trajectory,
+                   TaskGraphT &&cpu_exec)
+        : Impl(mgr_cfg,
+               action_buffer,
+               reset_buffer,
+               world_scenes.data(),
+               (uint32_t)load_result.uniqueSceneInfos.size(),
+               std::move(render_gpu_state), std::move(render_mgr),
+               mgr_cfg.raycastOutputResolution),
+          loadResult(std::move(load_result)),
+          instanceEntities(std::move(instance_entities)),
+          worldScenes(std::move(world_scenes)),
+          cameraTrajectory(std::move(camera_trajectory)),
+          cpuExec(std::move(cpu_exec))
+    {}
+
+    inline virtual ~CPUImpl() final {}
+
+    inline virtual void initWorlds()
+    {
+        cpuExec.runTaskGraph(TaskGraphID::Init);
+    }
+
+    inline virtual void run()
+    {
+        cpuExec.runTaskGraph(TaskGraphID::Step);
+        cpuExec.runTaskGraph(TaskGraphID::Render);
+    }
+
+    virtual inline Tensor exportTensor(ExportID slot,
+        TensorElementType type,
+        madrona::Span<const int64_t> dims) const final
+    {
+        void *dev_ptr = cpuExec.getExported((uint32_t)slot);
+        return Tensor(dev_ptr, type, dims, Optional<int>::none());
+    }
+};
+
 #ifdef MADRONA_CUDA_SUPPORT
 struct Manager::CUDAImpl final : Manager::Impl {
     MWCudaExecutor gpuExec;
@@ -146,6 +229,9 @@ struct Manager::CUDAImpl final : Manager::Impl {
 
     inline CUDAImpl(const Manager::Config &mgr_cfg,
                    Action *action_buffer,
+                   WorldReset *reset_buffer,
+                   uint32_t *world_scenes_buffer,
+                   uint32_t num_loaded_scenes,
                    Optional<RenderGPUState> &&render_gpu_state,
                    Optional<render::RenderManager> &&render_mgr,
                    MWCudaExecutor &&gpu_exec,
@@ -154,6 +240,9 @@ struct Manager::CUDAImpl final : Manager::Impl {
                    Optional<MWCudaLaunchGraph> &&render_graph)
         : Impl(mgr_cfg,
                action_buffer,
+               reset_buffer,
+               world_scenes_buffer,
+               num_loaded_scenes,
                std::move(render_gpu_state), std::move(render_mgr),
                mgr_cfg.raycastOutputResolution),
           gpuExec(std::move(gpu_exec)),
@@ -164,6 +253,14 @@ struct Manager::CUDAImpl final : Manager::Impl {
 
     inline virtual ~CUDAImpl() final {}
 
+    inline virtual void initWorlds()
+    {
+        MWCudaLaunchGraph init_graph =
+            gpuExec.buildLaunchGraph(TaskGraphID::Init);
+
+        gpuExec.run(init_graph);
+    }
+
     inline virtual void run()
     {
         gpuExec.run(stepGraph);
@@ -182,62 +279,275 @@ struct Manager::CUDAImpl final : Manager::Impl {
         return Tensor(dev_ptr, type, dims, cfg.gpuID);
     }
 };
-#else
-static_assert(false, "This only works with the CUDA backend");
 #endif
 
-static Optional<imp::SourceTexture> ktxImageImportFn(
-        void *data, size_t num_bytes)
+// Largest texture dimension ktxImageImportFn imports, 0 for full
+// resolution. Image handlers are plain function pointers, so the importer
+// configure callback stores the dimension for the import thread it runs on.
+static thread_local uint32_t ktxMaxTextureDim = 0;
+
+static bool transcodeKTX(const void *data, size_t num_bytes,
+                         run::TranscodedTexture &out)
 {
     ktx::ConvertedOutput converted = {};
     ktx::loadKTXMem(data, num_bytes, &converted);
 
-    return imp::SourceTexture {
+    if (converted.textureData == nullptr) {
+        return false;
+    }
+
+    out = run::TranscodedTexture {
         .data = converted.textureData,
-        .format = imp::SourceTextureFormat::BC7,
         .width = (uint32_t)converted.width,
         .height = (uint32_t)converted.height,
-        .numBytes = converted.bufferSize
+        .numBytes = converted.bufferSize,
     };
+
+    return true;
 }
 
-struct LoadResult {
-    std::vector<ImportedInstance> importedInstances;
-    std::vector<UniqueScene> uniqueSceneInfos;
-};
+static Optional<imp::SourceTexture> ktxImageImportFn(
+        void *data, size_t num_bytes)
+{
+    return run::importKTX2Texture(data, num_bytes, ktxMaxTextureDim,
+        std::filesystem::path(DATA_DIR) / "cache", transcodeKTX);
+}
+
+static void configureImporter(imp::AssetImporter &importer,
+                              uint32_t max_texture_dim)
+{
+    ktxMaxTextureDim = max_texture_dim;
 
-static imp::ImportedAssets loadScenes(
+    // Setup importer to handle KTX images
+    imp::ImageImporter &img_importer = importer.imageImporter();
+    img_importer.addHandler("ktx2", ktxImageImportFn);
+}
+
+static void loadRenderObjects(
         Optional<render::RenderManager> &render_mgr,
-        uint32_t first_unique_scene,
-        uint32_t num_unique_scenes,
-        LoadResult &load_result)
+        const run::LoadedAssets &assets)
+{
+    if (render_mgr.has_value()) {
+        render_mgr->loadObjects(assets.objects(),
+                assets.materials(),
+                assets.textures());
+
+        render_mgr->configureLighting({
+            { true, math::Vector3{1.0f, -1.0f, -0.05f}, math::Vector3{1.0f, 1.0f, 1.0f} }
+        });
+    }
+}
+
+// Replaces the imported objects with one merged object per unique scene.
+// Each scene's static instances become a single instance of its merged
+// object; dynamic instances are kept as separate instances after it, so
+// they still get their own entities and can be moved.
+static void mergeSceneInstances(LoadResult &load_result,
+                                run::LoadedAssets &assets)
+{
+    std::vector<ImportedInstance> merged_instances;
+    std::vector<imp::SourceObject> merged_objects;
+    std::vector<run::InstanceTransform> transforms;
+    std::vector<ImportedInstance> dynamic_instances;
+
+    // Dynamic instances still reference the imported objects, which are
+    // appended after the merged ones
+    uint32_t num_scene_objects = load_result.uniqueSceneInfos.size();
+    std::vector<int32_t> dynamic_object_ids(assets.objects().size(), -1);
+    std::vector<imp::SourceObject> dynamic_objects;
+
+    for (UniqueScene &scene : load_result.uniqueSceneInfos) {
+        transforms.clear();
+        dynamic_instances.clear();
+        for (uint32_t i = 0; i < scene.numInstances; i++) {
+            const ImportedInstance &inst =
+                load_result.importedInstances[scene.instancesOffset + i];
+
+            if (inst.dynamic) {
+                int32_t &object_id = dynamic_object_ids[inst.objectID];
+                if (object_id == -1) {
+                    object_id = (int32_t)(num_scene_objects +
+                                          dynamic_objects.size());
+                    dynamic_objects.push_back(
+                        assets.objects()[inst.objectID]);
+                }
+
+                ImportedInstance dyn_inst = inst;
+                dyn_inst.objectID = object_id;
+                dynamic_instances.push_back(dyn_inst);
+                continue;
+            }
+
+            transforms.push_back({
+                .position = inst.position,
+                .rotation = inst.rotation,
+                .scale = inst.scale,
+                .objectID = (uint32_t)inst.objectID,
+            });
+        }
+
+        // The stage is always static, so every scene has a merged object
+        run::MergedObject merged = run::mergeInstances(assets.objects(),
+            Span<const run::InstanceTransform>(
+                transforms.data(), transforms.size()));
+
+        scene.instancesOffset = merged_instances.size();
+        scene.numInstances = 1 + dynamic_instances.size();
+
+        merged_instances.push_back({
+            .position = { 0.f, 0.f, 0.f },
+            .rotation = Quat { 1.f, 0.f, 0.f, 0.f },
+            .scale = Diag3x3 { 1.f, 1.f, 1.f },
+            .objectID = (int32_t)merged_objects.size(),
+            .dynamic = false,
+        });
+        merged_instances.insert(merged_instances.end(),
+            dynamic_instances.begin(), dynamic_instances.end());
+
+        merged_objects.push_back(merged.object);
+        assets.extraStorage.push_back(std::move(merged.storage));
+    }
+
+    printf("Merged %zu instances into %zu scene objects, %zu dynamic "
+           "instances kept\n", load_result.importedInstances.size(),
+           merged_objects.size(),
+           merged_instances.size() - merged_objects.size());
+
+    merged_objects.insert(merged_objects.end(),
+        dynamic_objects.begin(), dynamic_objects.end());
+
+    load_result.importedInstances = std::move(merged_instances);
+    assets.importedObjects = std::move(merged_objects);
+}
+
+// Dataset locations, HSSD unless MADRONA_PROC_THOR=1
+struct DatasetPaths {
+    bool procThor;
+    std::string scenesDir;
+    std::string procThorRoot;
+    std::string procThorObjRoot;
+};
+
+static DatasetPaths datasetPaths()
 {
-    const char *cache_everything = getenv("MADRONA_CACHE_ALL_BVH");
     const char *proc_thor = getenv("MADRONA_PROC_THOR");
 
-    std::string hssd_scenes = std::filesystem::path(DATA_DIR) /
-        "hssd-hab/scenes";
-    std::string procthor_scenes = std::filesystem::path(DATA_DIR) /
-        "ai2thor-hab/ai2thor-hab/configs/scenes/ProcTHOR/5";
-    std::string procthor_root = std::filesystem::path(DATA_DIR) /
-        "ai2thor-hab/ai2thor-hab/configs";
+    DatasetPaths paths {
+        .procThor = proc_thor && proc_thor[0] == '1',
+        .scenesDir = std::filesystem::path(DATA_DIR) / "hssd-hab/scenes",
+        .procThorRoot = std::filesystem::path(DATA_DIR) /
+            "ai2thor-hab/ai2thor-hab/configs",
+        .procThorObjRoot = std::filesystem::path(DATA_DIR) /
+            "ai2thor-hab/ai2thorhab-uncompressed/configs",
+    };
 
-    //Use Uncompressed because our GLTF loader doesn't support loading compressed vertex formats
-    std::string procthor_obj_root = std::filesystem::path(DATA_DIR) /
-        "ai2thor-hab/ai2thorhab-uncompressed/configs";
+    // Compressed objects are decoded at import, so the uncompressed copy
+    // of the dataset is only used if it was downloaded.
+    if (!std::filesystem::exists(paths.procThorObjRoot)) {
+        paths.procThorObjRoot = paths.procThorRoot;
+    }
 
-    //Uncomment this for procthor
-    if (proc_thor && proc_thor[0] == '1') {
-        hssd_scenes = procthor_scenes;
+    if (paths.procThor) {
+        paths.scenesDir = std::filesystem::path(DATA_DIR) /
+            "ai2thor-hab/ai2thor-hab/configs/scenes/ProcTHOR/5";
     }
-    
+
+    return paths;
+}
+
+// Object manifests are keyed by the scene directory and its modification
+// time, which changes whenever scenes are added or removed. Edits to
+// object configs aren't noticed: rerun habitat_manifest after changing
+// them.
+static std::filesystem::path objectManifestPath(const DatasetPaths &dataset,
+                                                uint64_t &key)
+{
+    key = run::hashString("habitat_manifest", 0);
+    key = run::hashString(dataset.scenesDir, key);
+    if (dataset.procThor) {
+        key = run::hashString(dataset.procThorObjRoot, key);
+    }
+
+    std::error_code err;
+    auto mod_time = std::filesystem::last_write_time(dataset.scenesDir, err);
+    key = run::hashValue(
+        err ? ~0ll : (int64_t)mod_time.time_since_epoch().count(), key);
+
+    return run::assetCachePath(
+        std::filesystem::path(DATA_DIR) / "cache", "manifest", key);
+}
+
+// Used unless HABITAT_MANIFEST=0. Null if it hasn't been built.
+static std::unique_ptr<HabitatJSON::ObjectManifest> loadObjectManifest(
+    const DatasetPaths &dataset)
+{
+    const char *manifest_str = getenv("HABITAT_MANIFEST");
+    if (manifest_str && manifest_str[0] == '0') {
+        return nullptr;
+    }
+
+    uint64_t key;
+    std::filesystem::path path = objectManifestPath(dataset, key);
+
+    return HabitatJSON::ObjectManifest::load(path, key);
+}
+
+static std::vector<std::string> listSceneFiles(
+    const DatasetPaths &dataset,
+    const HabitatJSON::ObjectManifest *manifest)
+{
     std::vector<std::string> scene_paths;
 
+    if (manifest) {
+        scene_paths.reserve(manifest->numSceneFiles());
+        for (uint32_t i = 0; i < manifest->numSceneFiles(); i++) {
+            scene_paths.push_back(std::filesystem::path(dataset.scenesDir) /
+                                  manifest->sceneFile(i));
+        }
+
+        return scene_paths;
+    }
+
     for (const auto &dir_entry :
-            std::filesystem::directory_iterator(hssd_scenes)) {
+            std::filesystem::directory_iterator(dataset.scenesDir)) {
         scene_paths.push_back(dir_entry.path());
     }
 
+    return scene_paths;
+}
+
+static HabitatJSON::Scene loadSceneJSON(
+    const DatasetPaths &dataset,
+    const std::string &scene_path,
+    HabitatJSON::TemplateCache &template_cache,
+    const HabitatJSON::ObjectManifest *manifest)
+{
+    if (dataset.procThor) {
+        return HabitatJSON::procThorJSONLoad(
+            dataset.procThorRoot, dataset.procThorObjRoot, scene_path,
+            &template_cache, manifest);
+    } else {
+        return HabitatJSON::habitatJSONLoad(
+            scene_path, &template_cache, manifest);
+    }
+}
+
+static run::LoadedAssets loadScenes(
+        uint32_t first_unique_scene,
+        uint32_t num_unique_scenes,
+        uint32_t max_texture_dim,
+        bool merge_static,
+        LoadResult &load_result)
+{
+    const char *cache_everything = getenv("MADRONA_CACHE_ALL_BVH");
+
+    DatasetPaths dataset = datasetPaths();
+    std::unique_ptr<HabitatJSON::ObjectManifest> manifest =
+        loadObjectManifest(dataset);
+
+    std::vector<std::string> scene_paths =
+        listSceneFiles(dataset, manifest.get());
+
     if (cache_everything && std::stoi(cache_everything) == 1) {
         num_unique_scenes = scene_paths.size();
     }
@@ -263,6 +573,88 @@ static imp::ImportedAssets loadScenes(
 
     std::shuffle(random_indices.begin(), random_indices.end(), rng);
 
+    // The baked cache is keyed by the selected scene files and the load
+    // settings. Files the scenes pull in (stage and object configs, the
+    // object manifest and render assets) are only known after parsing, so
+    // they are recorded as cache dependencies and checked when mapping.
+    bool use_asset_cache = run::assetCacheEnabled();
+    uint64_t cache_key = run::hashString("habitat", 0);
+    cache_key = run::hashValue(sizeof(ImportedInstance), cache_key);
+    cache_key = run::hashValue(sizeof(UniqueScene), cache_key);
+    cache_key = run::hashValue(max_texture_dim, cache_key);
+    cache_key = run::hashValue(scale, cache_key);
+    cache_key = run::hashValue(height_offset, cache_key);
+    cache_key = run::hashValue(merge_static, cache_key);
+    cache_key = run::hashValue(manifest != nullptr, cache_key);
+    cache_key = run::hashString(dataset.scenesDir, cache_key);
+    for (uint32_t i = first_unique_scene; i < num_unique_scenes; i++) {
+        cache_key = run::hashFileStamp(
+            scene_paths[random_indices[i]], cache_key);
+    }
+
+    std::filesystem::path cache_path = run::assetCachePath(
+        std::filesystem::path(DATA_DIR) / "cache", "habitat", cache_key);
+
+    if (use_asset_cache) {
+        auto cached = run::AssetCache::load(cache_path, cache_key);
+        if (cached.has_value()) {
+            printf("Loaded baked scenes from %s\n", cache_path.c_str());
+
+            load_result.importedInstances =
+                cached->section<ImportedInstance>(0);
+            load_result.uniqueSceneInfos = cached->section<UniqueScene>(1);
+
+            return run::LoadedAssets {
+                .cached = std::move(cached),
+            };
+        }
+    }
+
+    // Objects are deduplicated across all loaded scenes, keyed by canonical
+    // path, so a GLB shared by many scenes is imported once. Raw paths are
+    // memoized as well to avoid canonicalizing every instance.
+    std::unordered_map<std::string, uint32_t> loaded_gltfs;
+    std::unordered_map<std::string, uint32_t> raw_path_objects;
+
+    auto getObjectID = [&](const std::filesystem::path &path) -> int32_t {
+        std::string raw_path = path.string();
+        auto raw_iter = raw_path_objects.find(raw_path);
+        if (raw_iter != raw_path_objects.end()) {
+            return (int32_t)raw_iter->second;
+        }
+
+        std::string canonical_path =
+            std::filesystem::weakly_canonical(path).string();
+        auto [iter, insert_success] = loaded_gltfs.emplace(
+            canonical_path, (uint32_t)render_asset_paths.size());
+        if (insert_success) {
+            render_asset_paths.push_back(canonical_path);
+        }
+
+        raw_path_objects.emplace(std::move(raw_path), iter->second);
+
+        return (int32_t)iter->second;
+    };
+
+    // Scene JSON files are independent, so parse them in parallel. Object
+    // and stage templates are shared between scenes through the template
+    // cache. Results are merged below in scene order so object IDs and
+    // instance offsets don't depend on thread scheduling.
+    uint32_t num_selected_scenes = first_unique_scene < num_unique_scenes ?
+        num_unique_scenes - first_unique_scene : 0;
+
+    std::vector<HabitatJSON::Scene> parsed_scenes(num_selected_scenes);
+    HabitatJSON::TemplateCache template_cache;
+
+    run::parallelFor(num_selected_scenes, run::numLoadThreads(),
+                     [&](uint64_t scene_idx) {
+        const std::string &scene_path =
+            scene_paths[random_indices[first_unique_scene + scene_idx]];
+
+        parsed_scenes[scene_idx] = loadSceneJSON(
+            dataset, scene_path, template_cache, manifest.get());
+    });
+
     // Get all the asset paths and push unique scene infos
     uint32_t num_loaded_scenes = 0;
 
@@ -270,19 +662,8 @@ static imp::ImportedAssets loadScenes(
         int random_index = random_indices[i];
         printf("Loading scene with %d\n", random_index);
 
-        std::string scene_path = scene_paths[random_index];
-
-        HabitatJSON::Scene loaded_scene;
-
-        //uncomment this for procthor
-        if (proc_thor && proc_thor[0] == '1') {
-            loaded_scene = HabitatJSON::procThorJSONLoad(
-                    procthor_root,
-                    procthor_obj_root,
-                    scene_path);
-        } else {
-            loaded_scene = HabitatJSON::habitatJSONLoad(scene_path);
-        }
+        const HabitatJSON::Scene &loaded_scene =
+            parsed_scenes[i - first_unique_scene];
 
         // Store the current imported instances offset
         uint32_t imported_instances_offset = 
@@ -307,81 +688,63 @@ static imp::ImportedAssets loadScenes(
             .position = stage_rot.rotateVec({ 0.f, 0.f, 0.f + height_offset }),
             .rotation = stage_rot,
             .scale = { scale, scale, scale },
-            .objectID = (int32_t)render_asset_paths.size(),
+            .objectID = getObjectID(loaded_scene.stagePath),
+            .dynamic = false,
         });
 
-        render_asset_paths.push_back(loaded_scene.stagePath.string());
-
-        std::unordered_map<std::string, uint32_t> loaded_gltfs;
-        std::unordered_map<uint32_t, uint32_t> object_to_imported_instance;
         uint32_t num_center_contribs = 0;
 
+        // Object IDs of the scene's interned paths, so each distinct path
+        // is looked up once per scene rather than once per instance.
+        // Openings resolve to configs instead of GLBs and are skipped.
+        constexpr int32_t unresolvedObject = -1;
+        constexpr int32_t skippedObject = -2;
+        std::vector<int32_t> path_objects(
+            loaded_scene.strings.size(), unresolvedObject);
+
+        auto sceneObjectID = [&](uint32_t path_idx) {
+            int32_t &object_id = path_objects[path_idx];
+            if (object_id == unresolvedObject) {
+                std::string_view path = loaded_scene.strings.get(path_idx);
+                object_id = path.ends_with(".json") ? skippedObject :
+                    getObjectID(std::filesystem::path(path));
+            }
+
+            return object_id;
+        };
+
         for (const HabitatJSON::AdditionalInstance &inst :
                 loaded_scene.additionalInstances) {
-            auto path_view = inst.gltfPath.string();
-            auto extension_pos = path_view.rfind('.');
-            assert(extension_pos != path_view.npos);
-            auto extension = path_view.substr(extension_pos + 1);
-
-            if (extension == "json") {
+            int32_t object_id = sceneObjectID(inst.gltfPath);
+            if (object_id == skippedObject) {
                 continue;
             }
 
-            auto [iter, insert_success] = loaded_gltfs.emplace(inst.gltfPath.string(), 
-                    render_asset_paths.size());
-            if (insert_success) {
-                auto pos = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }).
-                           rotateVec(Vector3{ inst.pos[0], inst.pos[1], 
-                                              inst.pos[2] + height_offset });
-
-                auto scale_vec = madrona::math::Diag3x3 {
-                    inst.scale[0] * scale,
-                    inst.scale[1] * scale,
-                    inst.scale[2] * scale
-                };
-                
-                ImportedInstance new_inst = {
-                    .position = {pos.x * scale, pos.y * scale, pos.z * scale},
-                    .rotation = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }) * 
-                                Quat{ inst.rotation[0], inst.rotation[1],
-                                      inst.rotation[2], inst.rotation[3] },
-                    .scale = scale_vec,
-                    .objectID = (int32_t)render_asset_paths.size(),
-                };
-
-                unique_scene_info.center += math::Vector3{
-                    new_inst.position.x, new_inst.position.y, 0.f };
-                num_center_contribs++;
-
-                load_result.importedInstances.push_back(new_inst);
-                render_asset_paths.push_back(inst.gltfPath.string());
-            } else {
-                // Push the instance to the instances array
-                auto pos = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }).
-                           rotateVec(Vector3{ inst.pos[0], inst.pos[1], 
-                                              inst.pos[2] + height_offset });
-
-                auto scale_vec = madrona::math::Diag3x3 {
-                    inst.scale[0] * scale,
-                    inst.scale[1] * scale,
-                    inst.scale[2] * scale
-                };
-
-                ImportedInstance new_inst = {
-                    .position = {pos.x * scale,pos.y * scale,pos.z * scale},
-                    .rotation = Quat::angleAxis(pi_d2,{ 1.f, 0.f, 0.f }) *
-                                Quat{ inst.rotation[0], inst.rotation[1],
-                                      inst.rotation[2], inst.rotation[3] },
-                    .scale = scale_vec,
-                    .objectID = (int32_t)iter->second,
-                };
-
-                unique_scene_info.center += math::Vector3{
-                    new_inst.position.x, new_inst.position.y, 0.f };
-                num_center_contribs++;
-
-                load_result.importedInstances.push_back(new_inst);
-            }
+            auto pos = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }).
+                       rotateVec(Vector3{ inst.pos[0], inst.pos[1], 
+                                          inst.pos[2] + height_offset });
+
+            auto scale_vec = madrona::math::Diag3x3 {
+                inst.scale[0] * scale,
+                inst.scale[1] * scale,
+                inst.scale[2] * scale
+            };
+
+            ImportedInstance new_inst = {
+                .position = {pos.x * scale, pos.y * scale, pos.z * scale},
+                .rotation = Quat::angleAxis(pi_d2, { 1.f, 0.f, 0.f }) * 
+                            Quat{ inst.rotation[0], inst.rotation[1],
+                                  inst.rotation[2], inst.rotation[3] },
+                .scale = scale_vec,
+                .objectID = object_id,
+                .dynamic = inst.dynamic,
+            };
+
+            unique_scene_info.center += math::Vector3{
+                new_inst.position.x, new_inst.position.y, 0.f };
+            num_center_contribs++;
+
+            load_result.importedInstances.push_back(new_inst);
 
             unique_scene_info.numInstances =
                 load_result.importedInstances.size() - unique_scene_info.instancesOffset;
@@ -394,41 +757,147 @@ static imp::ImportedAssets loadScenes(
         num_loaded_scenes++;
     }
 
-    std::vector<const char *> render_asset_cstrs;
-    for (size_t i = 0; i < render_asset_paths.size(); i++) {
-        render_asset_cstrs.push_back(render_asset_paths[i].c_str());
+    printf("Loaded %u scenes referencing %zu unique objects\n",
+           num_loaded_scenes, render_asset_paths.size());
+
+    run::LoadedAssets assets {
+        .cached = Optional<run::AssetCache>::none(),
+    };
+
+    std::array<char, 1024> import_err;
+    if (!run::importAssetsParallel(
+            Span<const std::string>(
+                render_asset_paths.data(), render_asset_paths.size()),
+            run::numLoadThreads(),
+            [max_texture_dim](imp::AssetImporter &importer) {
+                configureImporter(importer, max_texture_dim);
+            },
+            std::filesystem::path(DATA_DIR) / "cache", assets,
+            Span<char>(import_err.data(), import_err.size()))) {
+        FATAL("Failed to load render assets: %s", import_err);
+    }
+
+    if (merge_static) {
+        mergeSceneInstances(load_result, assets);
     }
 
-    imp::AssetImporter importer;
+    if (use_asset_cache) {
+        std::array<run::AssetCacheSection, 2> sections {
+            run::asCacheSection(load_result.importedInstances),
+            run::asCacheSection(load_result.uniqueSceneInfos),
+        };
 
-    // Setup importer to handle KTX images
-    imp::ImageImporter &img_importer = importer.imageImporter();
-    img_importer.addHandler("ktx2", ktxImageImportFn);
+        std::vector<std::string> cache_deps = render_asset_paths;
+        for (std::string &config_path : template_cache.paths()) {
+            cache_deps.push_back(std::move(config_path));
+        }
 
-    std::array<char, 1024> import_err;
-    auto render_assets = importer.importFromDisk(
-        render_asset_cstrs, Span<char>(import_err.data(), import_err.size()),
-        true);
+        if (manifest) {
+            uint64_t manifest_key;
+            cache_deps.push_back(
+                objectManifestPath(dataset, manifest_key).string());
+        }
+
+        if (run::writeAssetCache(cache_path, cache_key,
+                Span<const run::AssetCacheSection>(
+                    sections.data(), sections.size()),
+                Span<const std::string>(
+                    cache_deps.data(), cache_deps.size()),
+                assets.objects(), assets.materials(), assets.textures())) {
+            printf("Baked scenes to %s\n", cache_path.c_str());
+        }
+    }
 
     if (cache_everything && std::stoi(cache_everything) == 1) {
         exit(0);
     }
 
-    if (!render_assets.has_value()) {
-        FATAL("Failed to load render assets: %s", import_err);
+    return assets;
+}
+
+// Scene range selected by HSSD_FIRST_SCENE / HSSD_NUM_SCENES
+static void sceneRangeFromEnv(uint32_t &first_scene, uint32_t &num_scenes)
+{
+    const char *first_unique_scene_str = getenv("HSSD_FIRST_SCENE");
+    const char *num_unique_scene_str = getenv("HSSD_NUM_SCENES");
+
+    first_scene = 0;
+    num_scenes = 1;
+
+    if (first_unique_scene_str) {
+        first_scene = std::stoi(first_unique_scene_str);
     }
 
-    if (render_mgr.has_value()) {
-        render_mgr->loadObjects(render_assets->objects, 
-                render_assets->materials,
-                render_assets->textures);
+    if (num_unique_scene_str) {
+        num_scenes = std::stoi(num_unique_scene_str);
+    }
+}
 
-        render_mgr->configureLighting({
-            { true, math::Vector3{1.0f, -1.0f, -0.05f}, math::Vector3{1.0f, 1.0f, 1.0f} }
-        });
+// Agents (and so cameras / views) per world selected by HIDESEEK_NUM_AGENTS
+static uint32_t numAgentsFromEnv()
+{
+    const char *num_agents_str = getenv("HIDESEEK_NUM_AGENTS");
+    if (!num_agents_str) {
+        return 1;
     }
 
-    return std::move(*render_assets);
+    int32_t num_agents = std::stoi(num_agents_str);
+    if (num_agents < 1 || num_agents > (int32_t)consts::maxAgents) {
+        FATAL("HIDESEEK_NUM_AGENTS must be in [1, %d], got %d",
+              (int32_t)consts::maxAgents, num_agents);
+    }
+
+    return (uint32_t)num_agents;
+}
+
+// Points sim_cfg at the MADRONA_CAMERA_TRAJECTORY poses, if set. The
+// returned mapping must outlive the worlds when they read it directly.
+static std::unique_ptr<run::CameraTrajectory> loadCameraTrajectory(
+    Sim::Config &sim_cfg)
+{
+    static_assert(sizeof(TrajectoryPose) ==
+        sizeof(float) * run::CameraTrajectory::floatsPerPose);
+
+    std::unique_ptr<run::CameraTrajectory> trajectory =
+        run::cameraTrajectoryFromEnv(sim_cfg.numAgents);
+
+    if (!trajectory) {
+        sim_cfg.trajectoryPoses = nullptr;
+        sim_cfg.numTrajectories = 0;
+        sim_cfg.trajectoryViews = 0;
+        sim_cfg.trajectoryLen = 0;
+        return nullptr;
+    }
+
+    sim_cfg.trajectoryPoses = (const TrajectoryPose *)trajectory->poses();
+    sim_cfg.numTrajectories = trajectory->numTrajectories();
+    sim_cfg.trajectoryViews = trajectory->numViews();
+    sim_cfg.trajectoryLen = trajectory->numSteps();
+
+    return trajectory;
+}
+
+// Worlds only instantiate the scene they sample, so the per-world render
+// instance table only needs to fit the largest one.
+static uint32_t maxSceneInstances(const LoadResult &load_result)
+{
+    uint32_t max_instances = 0;
+    for (const UniqueScene &scene : load_result.uniqueSceneInfos) {
+        max_instances = std::max(max_instances, scene.numInstances);
+    }
+
+    return std::max(max_instances, 1u);
+}
+
+// Textures only need to be as detailed as the views rendering them
+static uint32_t importTextureDim(const Manager::Config &mgr_cfg)
+{
+    uint32_t view_width = mgr_cfg.enableBatchRenderer ?
+        mgr_cfg.batchRenderViewWidth : mgr_cfg.raycastOutputResolution;
+    uint32_t view_height = mgr_cfg.enableBatchRenderer ?
+        mgr_cfg.batchRenderViewHeight : mgr_cfg.raycastOutputResolution;
+
+    return run::maxTextureDimForView(view_width, view_height);
 }
 
 Manager::Impl * Manager::Impl::init(
@@ -438,13 +907,10 @@ Manager::Impl * Manager::Impl::init(
     sim_cfg.autoReset = mgr_cfg.autoReset;
     sim_cfg.initRandKey = rand::initKey(mgr_cfg.randSeed);
 
-    const char *num_agents_str = getenv("HIDESEEK_NUM_AGENTS");
-    if (num_agents_str) {
-        uint32_t num_agents = std::stoi(num_agents_str);
-        sim_cfg.numAgents = num_agents;
-    } else {
-        sim_cfg.numAgents = 1;
-    }
+    sim_cfg.numAgents = numAgentsFromEnv();
+
+    std::unique_ptr<run::CameraTrajectory> camera_trajectory =
+        loadCameraTrajectory(sim_cfg);
 
     switch (mgr_cfg.execMode) {
     case ExecMode::CUDA: {
@@ -454,35 +920,26 @@ Manager::Impl * Manager::Impl::init(
         Optional<RenderGPUState> render_gpu_state =
             initRenderGPUState(mgr_cfg);
 
-        Optional<render::RenderManager> render_mgr =
-            initRenderManager(mgr_cfg, render_gpu_state);
-
-        std::vector<ImportedInstance> imported_instances;
-
-        sim_cfg.mergeAll = false;
         sim_cfg.dynamicMovement = mgr_cfg.dynamicMovement;
 
-        const char *first_unique_scene_str = getenv("HSSD_FIRST_SCENE");
-        const char *num_unique_scene_str = getenv("HSSD_NUM_SCENES");
-
-        uint32_t first_scene = 0;
-        uint32_t num_scenes = 1;
-
-        if (first_unique_scene_str) {
-            first_scene = std::stoi(first_unique_scene_str);
-        }
-
-        if (num_unique_scene_str) {
-            num_scenes = std::stoi(num_unique_scene_str);
-        }
+        uint32_t first_scene, num_scenes;
+        sceneRangeFromEnv(first_scene, num_scenes);
 
         LoadResult load_result = {};
 
         auto imported_assets = loadScenes(
-                render_mgr, first_scene,
+                first_scene,
                 num_scenes,
+                importTextureDim(mgr_cfg),
+                mgr_cfg.mergeStaticInstances,
                 load_result);
 
+        Optional<render::RenderManager> render_mgr =
+            initRenderManager(mgr_cfg, render_gpu_state,
+                              maxSceneInstances(load_result));
+
+        loadRenderObjects(render_mgr, imported_assets);
+
         sim_cfg.importedInstances = (ImportedInstance *)cu::allocGPU(
                 sizeof(ImportedInstance) *
                 load_result.importedInstances.size());
@@ -507,6 +964,24 @@ Manager::Impl * Manager::Impl::init(
                     load_result.uniqueSceneInfos.size(),
                     cudaMemcpyHostToDevice));
 
+        sim_cfg.maxSceneInstances = maxSceneInstances(load_result);
+        sim_cfg.instanceEntities = (Entity *)cu::allocGPU(sizeof(Entity) *
+            (uint64_t)mgr_cfg.numWorlds * sim_cfg.maxSceneInstances);
+
+        if (camera_trajectory) {
+            void *poses = cu::allocGPU(camera_trajectory->numPoseBytes());
+            REQ_CUDA(cudaMemcpy(poses, camera_trajectory->poses(),
+                        camera_trajectory->numPoseBytes(),
+                        cudaMemcpyHostToDevice));
+            sim_cfg.trajectoryPoses = (const TrajectoryPose *)poses;
+        }
+
+        std::vector<uint32_t> world_scenes(mgr_cfg.numWorlds, ~0u);
+        sim_cfg.worldScenes = (uint32_t *)cu::allocGPU(
+            sizeof(uint32_t) * mgr_cfg.numWorlds);
+        REQ_CUDA(cudaMemcpy(sim_cfg.worldScenes, world_scenes.data(),
+                    sizeof(uint32_t) * mgr_cfg.numWorlds,
+                    cudaMemcpyHostToDevice));
 
         if (render_mgr.has_value()) {
             sim_cfg.renderBridge = render_mgr->bridge();
@@ -547,10 +1022,10 @@ Manager::Impl * Manager::Impl::init(
             madrona::CudaBatchRenderConfig {
                 .renderMode = rt_render_mode,
                 // .importedAssets = &imported_assets,
-                .geoBVHData = render::AssetProcessor::makeBVHData(imported_assets.objects),
+                .geoBVHData = render::AssetProcessor::makeBVHData(imported_assets.objects()),
                 .materialData = render::AssetProcessor::initMaterialData(
-                        imported_assets.materials.data(), imported_assets.materials.size(),
-                        imported_assets.textures.data(), imported_assets.textures.size()),
+                        imported_assets.materials().data(), imported_assets.materials().size(),
+                        imported_assets.textures().data(), imported_assets.textures().size()),
                 .renderResolution = raycast_output_resolution,
                 .nearPlane = 3.f,
                 .farPlane = 1000.f
@@ -572,9 +1047,15 @@ Manager::Impl * Manager::Impl::init(
         Action *agent_actions_buffer = 
             (Action *)gpu_exec.getExported((uint32_t)ExportID::Action);
 
+        WorldReset *world_reset_buffer =
+            (WorldReset *)gpu_exec.getExported((uint32_t)ExportID::Reset);
+
         return new CUDAImpl {
             mgr_cfg,
             agent_actions_buffer,
+            world_reset_buffer,
+            sim_cfg.worldScenes,
+            sim_cfg.numUniqueScenes,
             std::move(render_gpu_state),
             std::move(render_mgr),
             std::move(gpu_exec),
@@ -587,12 +1068,164 @@ Manager::Impl * Manager::Impl::init(
 #endif
     } break;
     case ExecMode::CPU: {
-        FATAL("This environment doesn't support CPU backend");
+        Optional<RenderGPUState> render_gpu_state =
+            initRenderGPUState(mgr_cfg);
+
+        sim_cfg.dynamicMovement = mgr_cfg.dynamicMovement;
+
+        uint32_t first_scene, num_scenes;
+        sceneRangeFromEnv(first_scene, num_scenes);
+
+        LoadResult load_result = {};
+
+        // There is no raycaster on the CPU backend, so the imported assets
+        // are only needed by the render manager.
+        auto imported_assets = loadScenes(first_scene, num_scenes,
+                importTextureDim(mgr_cfg), mgr_cfg.mergeStaticInstances,
+                load_result);
+
+        Optional<render::RenderManager> render_mgr =
+            initRenderManager(mgr_cfg, render_gpu_state,
+                              maxSceneInstances(load_result));
+
+        loadRenderObjects(render_mgr, imported_assets);
+
+        sim_cfg.importedInstances = load_result.importedInstances.data();
+        sim_cfg.numImportedInstances = load_result.importedInstances.size();
+
+        sim_cfg.numUniqueScenes = load_result.uniqueSceneInfos.size();
+        sim_cfg.uniqueScenes = load_result.uniqueSceneInfos.data();
+
+        sim_cfg.maxSceneInstances = maxSceneInstances(load_result);
+        std::vector<Entity> instance_entities(
+            (uint64_t)mgr_cfg.numWorlds * sim_cfg.maxSceneInstances);
+        sim_cfg.instanceEntities = instance_entities.data();
+
+        std::vector<uint32_t> world_scenes(mgr_cfg.numWorlds, ~0u);
+        sim_cfg.worldScenes = world_scenes.data();
+
+        sim_cfg.numWorlds = mgr_cfg.numWorlds;
+
+        if (render_mgr.has_value()) {
+            sim_cfg.renderBridge = render_mgr->bridge();
+        } else {
+            sim_cfg.renderBridge = nullptr;
+        }
+
+        HeapArray<Sim::WorldInit> world_inits(mgr_cfg.numWorlds);
+
+        CPUImpl::TaskGraphT cpu_exec {
+            ThreadPoolExecutor::Config {
+                .numWorlds = mgr_cfg.numWorlds,
+                .numExportedBuffers = (uint32_t)ExportID::NumExports,
+            },
+            sim_cfg,
+            world_inits.data(),
+            (uint32_t)TaskGraphID::NumTaskGraphs,
+        };
+
+        Action *agent_actions_buffer =
+            (Action *)cpu_exec.getExported((uint32_t)ExportID::Action);
+
+        WorldReset *world_reset_buffer =
+            (WorldReset *)cpu_exec.getExported((uint32_t)ExportID::Reset);
+
+        return new CPUImpl {
+            mgr_cfg,
+            agent_actions_buffer,
+            world_reset_buffer,
+            std::move(render_gpu_state),
+            std::move(render_mgr),
+            std::move(load_result),
+            std::move(instance_entities),
+            std::move(world_scenes),
+            std::move(camera_trajectory),
+            std::move(cpu_exec),
+        };
     } break;
     default: MADRONA_UNREACHABLE();
     }
 }
 
+void Manager::bakeAssets(uint32_t first_scene, uint32_t num_scenes,
+                         uint32_t view_resolution, bool merge_static)
+{
+    LoadResult load_result = {};
+    loadScenes(first_scene, num_scenes,
+               run::maxTextureDimForView(view_resolution, view_resolution),
+               merge_static, load_result);
+}
+
+void Manager::buildObjectManifest()
+{
+    DatasetPaths dataset = datasetPaths();
+
+    // Always list the directory and resolve instances the slow way, so the
+    // manifest matches what loading without it produces.
+    std::vector<std::string> scene_paths = listSceneFiles(dataset, nullptr);
+
+    std::vector<HabitatJSON::Scene> parsed_scenes(scene_paths.size());
+    HabitatJSON::TemplateCache template_cache;
+
+    run::parallelFor(scene_paths.size(), run::numLoadThreads(),
+                     [&](uint64_t scene_idx) {
+        parsed_scenes[scene_idx] = loadSceneJSON(
+            dataset, scene_paths[scene_idx], template_cache, nullptr);
+    });
+
+    // Manifest paths are relative to the root the loaders join them with
+    std::filesystem::path object_root = dataset.procThor ?
+        std::filesystem::path(dataset.procThorObjRoot) :
+        std::filesystem::absolute(dataset.scenesDir).parent_path();
+
+    std::vector<HabitatJSON::ManifestEntry> entries;
+    std::unordered_map<std::string, uint32_t> indexed_templates;
+
+    for (const HabitatJSON::Scene &scene : parsed_scenes) {
+        for (const HabitatJSON::AdditionalInstance &inst :
+                scene.additionalInstances) {
+            std::string name(scene.strings.get(inst.name));
+            if (indexed_templates.count(name)) {
+                continue;
+            }
+
+            std::filesystem::path gltf_path(scene.strings.get(inst.gltfPath));
+            std::filesystem::path rel_path =
+                gltf_path.lexically_relative(object_root);
+            if (rel_path.empty()) {
+                fprintf(stderr, "Not indexing %s: %s is outside %s\n",
+                        name.c_str(), gltf_path.c_str(),
+                        object_root.c_str());
+                continue;
+            }
+
+            indexed_templates.emplace(name, (uint32_t)entries.size());
+            entries.push_back({
+                .templateName = std::move(name),
+                .renderAsset = rel_path.string(),
+            });
+        }
+    }
+
+    std::vector<std::string> scene_files;
+    scene_files.reserve(scene_paths.size());
+    for (const std::string &scene_path : scene_paths) {
+        scene_files.push_back(
+            std::filesystem::path(scene_path).filename().string());
+    }
+
+    uint64_t key;
+    std::filesystem::path manifest_path = objectManifestPath(dataset, key);
+
+    if (!HabitatJSON::ObjectManifest::write(
+            manifest_path, key, entries, scene_files)) {
+        FATAL("Failed to write object manifest %s", manifest_path.c_str());
+    }
+
+    printf("Indexed %zu templates from %zu scenes into %s\n",
+           entries.size(), scene_files.size(), manifest_path.c_str());
+}
+
 Manager::Manager(const Config &cfg)
     : impl_(Impl::init(cfg))
 {
@@ -604,14 +1237,10 @@ Manager::Manager(const Config &cfg)
     //
     // This will be improved in the future with support for multiple task
     // graphs, allowing a small task graph to be executed after initialization.
-    const char *num_agents_str = getenv("HIDESEEK_NUM_AGENTS");
-    if (num_agents_str) {
-        uint32_t num_agents = std::stoi(num_agents_str);
-        numAgents = num_agents;
-    } else {
-        numAgents = 1;
-    }
-    
+    numAgents = numAgentsFromEnv();
+
+    impl_->initWorlds();
+
     step();
 }
 
@@ -642,7 +1271,7 @@ Tensor Manager::actionTensor() const
         {
             impl_->cfg.numWorlds,
             numAgents,
-            4,
+            sizeof(Action) / sizeof(int32_t),
         });
 }
 
@@ -721,6 +1350,54 @@ void Manager::setAction(int32_t world_idx,
     }
 }
 
+void Manager::triggerReset(int32_t world_idx)
+{
+    WorldReset reset {
+        .reset = 1,
+    };
+
+    WorldReset *reset_ptr = impl_->worldResetBuffer + world_idx;
+
+    if (impl_->cfg.execMode == ExecMode::CUDA) {
+#ifdef MADRONA_CUDA_SUPPORT
+        cudaMemcpy(reset_ptr, &reset, sizeof(WorldReset),
+                   cudaMemcpyHostToDevice);
+#endif
+    } else {
+        *reset_ptr = reset;
+    }
+}
+
+void Manager::setWorldScenes(Span<const uint32_t> scenes)
+{
+    assert((uint32_t)scenes.size() == impl_->cfg.numWorlds);
+
+    if (impl_->cfg.execMode == ExecMode::CUDA) {
+#ifdef MADRONA_CUDA_SUPPORT
+        cudaMemcpy(impl_->worldScenesBuffer, scenes.data(),
+                   sizeof(uint32_t) * scenes.size(),
+                   cudaMemcpyHostToDevice);
+#endif
+    } else {
+        memcpy(impl_->worldScenesBuffer, scenes.data(),
+               sizeof(uint32_t) * scenes.size());
+    }
+}
+
+uint32_t Manager::numLoadedScenes() const
+{
+    return impl_->numLoadedScenes;
+}
+
+Tensor Manager::resetTensor() const
+{
+    return impl_->exportTensor(ExportID::Reset, TensorElementType::Int32,
+        {
+            impl_->cfg.numWorlds,
+            1,
+        });
+}
+
 render::RenderManager & Manager::getRenderManager()
 {
     return *impl_->renderMgr;
@@ -31,11 +31,27 @@ public:
 
         // Flip this to true by default for headless
         bool dynamicMovement = true;
+
+        // Pre-merge each scene's static instances into one object with a
+        // mesh per material
+        bool mergeStaticInstances = false;
     };
 
     Manager(const Config &cfg);
     ~Manager();
 
+    // Parses and imports the same scenes a Manager would (first_scene and
+    // num_scenes match HSSD_FIRST_SCENE / HSSD_NUM_SCENES, view_resolution
+    // the batch view size, merge_static Config::mergeStaticInstances) and
+    // writes the baked asset cache, without touching the GPU.
+    static void bakeAssets(uint32_t first_scene, uint32_t num_scenes,
+                           uint32_t view_resolution, bool merge_static);
+
+    // Resolves the render asset of every object template referenced by the
+    // dataset's scenes and writes the index scene loading uses to skip
+    // path derivation, object configs and listing the scene directory.
+    static void buildObjectManifest();
+
     void step();
 
     // These functions export Tensor objects that link the ECS
@@ -44,6 +60,15 @@ public:
     madrona::py::Tensor rgbTensor() const;
     madrona::py::Tensor depthTensor() const;
     madrona::py::Tensor raycastTensor() const;
+    madrona::py::Tensor resetTensor() const;
+
+    // Worlds switch scenes when they reset: at the end of each episode with
+    // autoReset, or on the step after triggerReset. setWorldScenes picks the
+    // loaded scene (< numLoadedScenes()) each world switches to next, ~0u
+    // picks one at random.
+    void triggerReset(int32_t world_idx);
+    void setWorldScenes(madrona::Span<const uint32_t> scenes);
+    uint32_t numLoadedScenes() const;
 
     // These functions are used by the viewer to control the simulation
     // with keyboard inputs in place of DNN policy actions
@@ -47,15 +47,21 @@ void Sim::registerTypes(ECSRegistry &registry, const Config &cfg)
 
     registry.registerComponent<Action>();
     registry.registerComponent<AgentCamera>();
+    registry.registerComponent<AgentIndex>();
+    registry.registerComponent<InstanceSpawnRange>();
     registry.registerArchetype<Agent>();
     registry.registerArchetype<DummyRenderable>();
+    registry.registerArchetype<InstanceSpawner>();
     registry.registerSingleton<TimeSingleton>();
+    registry.registerSingleton<WorldReset>();
 
     registry.exportColumn<Agent, Action>(
         (uint32_t)ExportID::Action);
     registry.exportColumn<render::RaycastOutputArchetype,
                           render::RGBOutputBuffer>(
         (uint32_t)ExportID::Raycast);
+    registry.exportSingleton<WorldReset>(
+        (uint32_t)ExportID::Reset);
 }
 
 #define DYNAMIC_MOVEMENT
@@ -65,8 +71,27 @@ inline void movementSystem(Engine &ctx,
                            Action &action, 
                            Rotation &rot,
                            Position &pos,
-                           AgentCamera& cam)
+                           AgentCamera& cam,
+                           const AgentIndex &agent_idx)
 {
+    const Sim &sim = ctx.data();
+
+    // Scripted cameras ignore actions and the dynamic movement
+    if (sim.trajectory != nullptr) {
+        const TrajectoryPose &pose = sim.trajectory[
+            (uint32_t)agent_idx.idx * sim.trajectoryLen + sim.trajectoryStep];
+
+        cam.yaw = pose.yaw;
+        cam.pitch = pose.pitch;
+
+        pos = pose.position;
+        pos.x += sim.worldCenter.x;
+        pos.y += sim.worldCenter.y;
+
+        rot = eulerToQuat(cam.yaw, cam.pitch);
+        return;
+    }
+
     Quat cur_rot = eulerToQuat(cam.yaw, 0);
     
     int actionX = action.x - 1;
@@ -132,10 +157,109 @@ inline void movementSystem(Engine &ctx,
     rot = eulerToQuat(cam.yaw, cam.pitch);
 }
 
+// Replaces one chunk of the world's instance slots: destroys the previous
+// scene's instance and creates the current scene's, writing the columns
+// straight through the new entity's location. Entities are still made and
+// registered with the renderer one at a time; reserving rows and copying
+// whole columns would need a bulk creation API in madrona.
+inline void spawnInstancesSystem(Engine &ctx,
+                                 const InstanceSpawnRange &range)
+{
+    Sim &sim = ctx.data();
+    const ImportedInstance *instances = sim.importedInstances;
+
+    for (uint32_t i = range.begin; i < range.end; i++) {
+        if (i < sim.numDespawnInstances) {
+            ctx.destroyRenderableEntity(sim.instanceEntities[i]);
+        }
+
+        if (i >= sim.numImportedInstances) {
+            continue;
+        }
+
+        const ImportedInstance &imp_inst = instances[i];
+
+        Entity e_inst = ctx.makeEntity<DummyRenderable>();
+        Loc loc = ctx.loc(e_inst);
+
+        ctx.getDirect<Position>(DummyRenderableCols::Position, loc) =
+            imp_inst.position;
+        ctx.getDirect<Rotation>(DummyRenderableCols::Rotation, loc) =
+            imp_inst.rotation;
+        ctx.getDirect<Scale>(DummyRenderableCols::Scale, loc) =
+            imp_inst.scale;
+        ctx.getDirect<ObjectID>(DummyRenderableCols::ObjectID, loc).idx =
+            imp_inst.objectID;
+
+        render::RenderingSystem::makeEntityRenderable(ctx, e_inst);
+
+        sim.instanceEntities[i] = e_inst;
+    }
+}
+
+// Switches the world to the scene assigned in Config::worldScenes (or a
+// random one) and queues the spawners that swap the instances over. The
+// instances are split into chunks so large scenes aren't spawned by a
+// single thread per world. A world resetting into the scene it already
+// has keeps its instances.
+static void loadScene(Engine &ctx)
+{
+    Sim &sim = ctx.data();
+
+    uint32_t scene_idx = sim.worldScenes[ctx.worldID().idx];
+    if (scene_idx >= sim.numUniqueScenes) {
+        scene_idx = (uint32_t)sim.rng.sampleI32(0, sim.numUniqueScenes);
+    }
+
+    if (scene_idx == sim.curScene) {
+        return;
+    }
+    sim.curScene = scene_idx;
+
+    const UniqueScene &scene = sim.uniqueScenes[scene_idx];
+
+    sim.numDespawnInstances = sim.numImportedInstances;
+    sim.importedInstances = sim.allImportedInstances + scene.instancesOffset;
+    sim.numImportedInstances = scene.numInstances;
+    sim.worldCenter = { scene.center.x, scene.center.y };
+
+    uint32_t num_slots =
+        std::max(sim.numDespawnInstances, sim.numImportedInstances);
+    for (uint32_t i = 0; i < num_slots; i += consts::instancesPerSpawner) {
+        Loc loc = ctx.makeTemporary<InstanceSpawner>();
+        ctx.getDirect<InstanceSpawnRange>(InstanceSpawnerCols::Range, loc) = {
+            .begin = i,
+            .end = std::min(i + consts::instancesPerSpawner, num_slots),
+        };
+    }
+}
+
+inline void resetSystem(Engine &ctx, WorldReset &reset)
+{
+    Sim &sim = ctx.data();
+
+    bool episode_done = sim.autoReset &&
+        sim.curEpisodeStep == consts::episodeLen - 1;
+
+    if (reset.reset != 0 || episode_done) {
+        reset.reset = 0;
+        sim.curEpisodeStep = 0;
+
+        loadScene(ctx);
+    } else {
+        sim.curEpisodeStep += 1;
+    }
+}
+
 inline void timeUpdateSys(Engine &ctx,
                           TimeSingleton &time_single)
 {
     time_single.currentTime += 0.05f;
+
+    Sim &sim = ctx.data();
+    if (sim.trajectory != nullptr) {
+        sim.trajectoryStep = (sim.trajectoryStep + 1) % sim.trajectoryLen;
+    }
 }
 
 #ifdef MADRONA_GPU_MODE
@@ -153,6 +277,27 @@ TaskGraph::NodeID queueSortByWorld(TaskGraph::Builder &builder,
 }
 #endif
 
+static TaskGraph::NodeID spawnInstancesTasks(
+    TaskGraphBuilder &builder,
+    Span<const TaskGraph::NodeID> deps)
+{
+    auto spawn_sys = builder.addToGraph<ParallelForNode<Engine,
+        spawnInstancesSystem,
+            InstanceSpawnRange
+        >>(deps);
+
+    return builder.addToGraph<ClearTmpNode<InstanceSpawner>>({spawn_sys});
+}
+
+static void setupInitTasks(TaskGraphBuilder &builder,
+                           const Sim::Config &cfg)
+{
+    auto spawn_done = spawnInstancesTasks(builder, {});
+
+    auto clear_tmp = builder.addToGraph<ResetTmpAllocNode>({spawn_done});
+    (void)clear_tmp;
+}
+
 static void setupStepTasks(TaskGraphBuilder &builder, 
                            const Sim::Config &cfg)
 {
@@ -163,7 +308,8 @@ static void setupStepTasks(TaskGraphBuilder &builder,
             Action,
             Rotation,
             Position,
-            AgentCamera
+            AgentCamera,
+            AgentIndex
         >>({});
 
     auto time_sys = builder.addToGraph<ParallelForNode<Engine,
@@ -171,7 +317,15 @@ static void setupStepTasks(TaskGraphBuilder &builder,
             TimeSingleton
         >>({move_sys});
 
-    auto clear_tmp = builder.addToGraph<ResetTmpAllocNode>({time_sys});
+    // Worlds that reset switch to their next scene
+    auto reset_sys = builder.addToGraph<ParallelForNode<Engine,
+         resetSystem,
+            WorldReset
+        >>({time_sys});
+
+    auto spawn_done = spawnInstancesTasks(builder, {reset_sys});
+
+    auto clear_tmp = builder.addToGraph<ResetTmpAllocNode>({spawn_done});
     (void)clear_tmp;
 
 #ifdef MADRONA_GPU_MODE
@@ -199,32 +353,28 @@ static void setupRenderTasks(TaskGraphBuilder &builder,
 // Build the task graph
 void Sim::setupTasks(TaskGraphManager &taskgraph_mgr, const Config &cfg)
 {
+    setupInitTasks(taskgraph_mgr.init(TaskGraphID::Init), cfg);
     setupStepTasks(taskgraph_mgr.init(TaskGraphID::Step), cfg);
     setupRenderTasks(taskgraph_mgr.init(TaskGraphID::Render), cfg);
 }
 
 static void loadInstances(Engine &ctx)
 {
-    for (int i = 0; i < (int)ctx.data().numImportedInstances; ++i) {
-        ImportedInstance *imp_inst = &ctx.data().importedInstances[i];
-
-        Entity e_inst = ctx.makeEntity<DummyRenderable>();
-        ctx.get<Position>(e_inst) = imp_inst->position;
-        ctx.get<Rotation>(e_inst) = imp_inst->rotation;
-        ctx.get<Scale>(e_inst) = imp_inst->scale;
-        ctx.get<ObjectID>(e_inst).idx = imp_inst->objectID;
-
-        render::RenderingSystem::makeEntityRenderable(ctx, e_inst);
-    }
-
-    { // Create the agent entity of this world
-        Entity agent = ctx.data().agent =
-            ctx.makeEntity<Agent>();
-
-        ctx.get<AgentCamera>(agent) = { 
-            .yaw = 0,
-            .pitch = 0 
+    // The scene instances themselves are created by the Init graph
+    loadScene(ctx);
+
+    // Create the agent entities of this world. Their views are ordered by
+    // agent index, and start out facing evenly spaced directions so they
+    // don't all render the same image.
+    Sim &sim = ctx.data();
+    for (uint32_t i = 0; i < sim.numAgents; i++) {
+        Entity agent = sim.agents[i] = ctx.makeEntity<Agent>();
+
+        ctx.get<AgentCamera>(agent) = {
+            .yaw = math::pi_m2 * (float)i / (float)sim.numAgents,
+            .pitch = 0
         };
+        ctx.get<AgentIndex>(agent).idx = (int32_t)i;
 
         // Create a render view for the agent
         render::RenderingSystem::attachEntityToView(ctx,
@@ -253,17 +403,35 @@ Sim::Sim(Engine &ctx,
     ctx.data().rng = RNG(rand::split_i(ctx.data().initRandKey,
         0, (uint32_t)ctx.worldID().idx));
 
-    uint32_t current_scene = ctx.data().rng.sampleI32(
-            0, cfg.numUniqueScenes);
-
-    UniqueScene *unique_scene = &cfg.uniqueScenes[current_scene];
-
-    importedInstances = cfg.importedInstances + 
-        unique_scene->instancesOffset;
+    allImportedInstances = cfg.importedInstances;
+    uniqueScenes = cfg.uniqueScenes;
+    numUniqueScenes = cfg.numUniqueScenes;
+    worldScenes = cfg.worldScenes;
+    instanceEntities = cfg.instanceEntities +
+        (uint64_t)ctx.worldID().idx * cfg.maxSceneInstances;
+
+    importedInstances = nullptr;
+    numImportedInstances = 0;
+    numDespawnInstances = 0;
+    curScene = ~0u;
+
+    numAgents = cfg.numAgents;
+
+    if (cfg.trajectoryPoses != nullptr) {
+        uint32_t trajectory_idx =
+            (uint32_t)ctx.worldID().idx % cfg.numTrajectories;
+        trajectory = cfg.trajectoryPoses + (uint64_t)trajectory_idx *
+            cfg.trajectoryViews * cfg.trajectoryLen;
+    } else {
+        trajectory = nullptr;
+    }
+    trajectoryLen = cfg.trajectoryLen;
+    trajectoryStep = 0;
 
-    numImportedInstances = unique_scene->numInstances;
+    curEpisodeStep = 0;
+    autoReset = cfg.autoReset;
 
-    worldCenter = { unique_scene->center.x, unique_scene->center.y };
+    ctx.singleton<WorldReset>().reset = 0;
 
     RenderingSystem::init(ctx, cfg.renderBridge);
 
@@ -1,7 +1,5 @@
 #pragma once
 
-// #define MERGE_ALL
-
 #include <madrona/taskgraph_builder.hpp>
 #include <madrona/custom_context.hpp>
 #include <madrona/rand.hpp>
@@ -20,6 +18,7 @@ class Engine;
 enum class ExportID : uint32_t {
     Action,
     Raycast,
+    Reset,
     NumExports,
 };
 
@@ -28,9 +27,13 @@ struct ImportedInstance {
     madrona::math::Quat rotation;
     madrona::math::Diag3x3 scale;
     int32_t objectID;
+    // Instances the scene marks as DYNAMIC aren't merged into the scene
+    // object by Config::mergeStaticInstances
+    bool dynamic;
 };
 
 enum class TaskGraphID : uint32_t {
+    Init,
     Step,
     Render,
     NumTaskGraphs,
@@ -50,6 +53,11 @@ struct TimeSingleton {
     float currentTime;
 };
 
+// Set to non-zero to switch the world to its next scene on the next step
+struct WorldReset {
+    int32_t reset;
+};
+
 // The Sim class encapsulates the per-world state of the simulation.
 // Sim is always available by calling ctx.data() given a reference
 // to the Engine / Context object that is passed to each ECS system.
@@ -72,11 +80,26 @@ struct Sim : public madrona::WorldBase {
         uint32_t numUniqueScenes;
         UniqueScene *uniqueScenes;
 
+        // Scene each world loads when it (re)sets, ~0u for a random one
+        uint32_t *worldScenes;
+
+        // maxSceneInstances slots per world for the spawned instances, so
+        // they can be destroyed when the world switches scenes
+        madrona::Entity *instanceEntities;
+        uint32_t maxSceneInstances;
+
         uint32_t numWorlds;
 
         uint32_t numAgents;
 
-        bool mergeAll;
+        // Optional camera trajectories replayed instead of movement:
+        // numTrajectories * trajectoryViews * trajectoryLen poses laid out
+        // [trajectory][view][step], null if there are none
+        const TrajectoryPose *trajectoryPoses;
+        uint32_t numTrajectories;
+        uint32_t trajectoryViews;
+        uint32_t trajectoryLen;
+
         bool dynamicMovement;
     };
 
@@ -95,13 +118,35 @@ struct Sim : public madrona::WorldBase {
     madrona::RandKey initRandKey;
     madrona::RNG rng;
 
+    // Instances of the world's current scene
     ImportedInstance *importedInstances;
     uint32_t numImportedInstances;
 
+    // Instances of the previous scene still to be destroyed by the spawners
+    uint32_t numDespawnInstances;
+
+    // Index into uniqueScenes of the spawned scene, ~0u before the first
+    uint32_t curScene;
+
+    ImportedInstance *allImportedInstances;
+    UniqueScene *uniqueScenes;
+    uint32_t numUniqueScenes;
+    uint32_t *worldScenes;
+    madrona::Entity *instanceEntities;
+
     madrona::math::Vector2 worldCenter;
 
-    madrona::Entity agent;
+    // This world's trajectory (trajectoryLen poses per view), or null
+    const TrajectoryPose *trajectory;
+    uint32_t trajectoryLen;
+    uint32_t trajectoryStep;
+
+    // Config::numAgents cameras, each with its own action and view
+    madrona::Entity agents[consts::maxAgents];
+    uint32_t numAgents;
 
+    int32_t curEpisodeStep;
+    bool autoReset;
     bool dynamicMovement;
 };
 
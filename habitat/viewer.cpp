@@ -226,7 +226,7 @@ int main(int argc, char *argv[])
 
             uint32_t bytes_per_image = 4 * output_resolution * output_resolution;
 
-            uint32_t image_idx = viewer.getCurrentWorldID() * 1 + 
+            uint32_t image_idx = viewer.getCurrentWorldID() * mgr.numAgents + 
                 std::max(viewer.getCurrentViewID(), (CountT)0);
 
             uint32_t base_image_idx = num_images_total * (image_idx / num_images_total);
@@ -24,6 +24,18 @@ NB_MODULE(gpu_hideseek, m) {
         .value("Default", SimFlags::Default)
         .value("UseFixedWorld", SimFlags::UseFixedWorld)
         .value("IgnoreEpisodeLength", SimFlags::IgnoreEpisodeLength)
+        .value("MergeStaticWalls", SimFlags::MergeStaticWalls)
+    ;
+
+    nb::enum_<PhysicsSolver>(m, "PhysicsSolver")
+        .value("XPBD", PhysicsSolver::XPBD)
+        .value("TGS", PhysicsSolver::TGS)
+    ;
+
+    nb::enum_<GraphVariant>(m, "GraphVariant")
+        .value("Train", GraphVariant::Train)
+        .value("Eval", GraphVariant::Eval)
+        .value("Debug", GraphVariant::Debug)
     ;
 
     nb::class_<Manager> (m, "HideAndSeekSimulator")
@@ -39,7 +51,16 @@ NB_MODULE(gpu_hideseek, m) {
                             uint32_t max_seekers,
                             bool enable_batch_render,
                             int64_t batch_render_width,
-                            int64_t batch_render_height) {
+                            int64_t batch_render_height,
+                            GraphVariant graph_variant,
+                            int64_t num_physics_substeps,
+                            PhysicsSolver physics_solver) {
+            if (num_physics_substeps < 1 ||
+                    num_physics_substeps > INT32_MAX) {
+                throw nb::value_error(
+                    "num_physics_substeps must be a positive int32");
+            }
+
             new (self) Manager(Manager::Config {
                 .execMode = exec_mode,
                 .gpuID = (int)gpu_id,
@@ -53,6 +74,9 @@ NB_MODULE(gpu_hideseek, m) {
                 .enableBatchRenderer = enable_batch_render,
                 .batchRenderViewWidth = (uint32_t)batch_render_width,
                 .batchRenderViewHeight = (uint32_t)batch_render_height,
+                .graphVariant = graph_variant,
+                .numPhysicsSubsteps = (uint32_t)num_physics_substeps,
+                .physicsSolver = physics_solver,
             });
         }, nb::arg("exec_mode"),
            nb::arg("gpu_id"),
@@ -65,7 +89,10 @@ NB_MODULE(gpu_hideseek, m) {
            nb::arg("max_seekers"),
            nb::arg("enable_batch_renderer") = false,
            nb::arg("batch_render_width") = 64,
-           nb::arg("batch_render_height") = 64)
+           nb::arg("batch_render_height") = 64,
+           nb::arg("graph_variant") = GraphVariant::Debug,
+           nb::arg("num_physics_substeps") = 4,
+           nb::arg("physics_solver") = PhysicsSolver::XPBD)
         .def("init", &Manager::init)
         .def("step", &Manager::step)
         .def("reset_tensor", &Manager::resetTensor)
@@ -86,6 +113,8 @@ NB_MODULE(gpu_hideseek, m) {
         .def("rgb_tensor", &Manager::rgbTensor)
         .def("lidar_tensor", &Manager::lidarTensor)
         .def("seed_tensor", &Manager::seedTensor)
+        .def("physics_activity_tensor", &Manager::physicsActivityTensor)
+        .def("physics_stability_tensor", &Manager::physicsStabilityTensor)
     ;
 }
 
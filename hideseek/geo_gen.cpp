@@ -47,6 +47,15 @@ public:
         return mCurrentSize;
     }
 
+    void clear() {
+        mCurrentSize = 0;
+    }
+
+    void resize(CountT newSize) {
+        assert(newSize <= mCurrentSize);
+        mCurrentSize = newSize;
+    }
+
 private:
     T *mItems;
     CountT mMaxSize;
@@ -182,6 +191,71 @@ struct Walls {
             walls[i].p2 = doScale(walls[i].p2);
         }
     }
+
+    // Fuse collinear walls that touch or overlap into a single segment.
+    // Splitting walls while connecting rooms leaves fragments that share an
+    // endpoint; door gaps are strictly positive and so are preserved.
+    inline void mergeCollinear() {
+        constexpr float eps = 0.0001f;
+
+        auto tryMerge = [](Wall &a, const Wall &b) {
+            bool a_horizontal = a.isHorizontal();
+            if (a_horizontal != b.isHorizontal()) {
+                return false;
+            }
+
+            if (a_horizontal) {
+                if (fabsf(a.p1.y - b.p1.y) > eps ||
+                        b.p1.x > a.p2.x + eps || a.p1.x > b.p2.x + eps) {
+                    return false;
+                }
+
+                a.p1.x = min(a.p1.x, b.p1.x);
+                a.p2.x = max(a.p2.x, b.p2.x);
+            } else {
+                if (fabsf(a.p1.x - b.p1.x) > eps ||
+                        b.p1.y > a.p2.y + eps || a.p1.y > b.p2.y + eps) {
+                    return false;
+                }
+
+                a.p1.y = min(a.p1.y, b.p1.y);
+                a.p2.y = max(a.p2.y, b.p2.y);
+            }
+
+            return true;
+        };
+
+        CountT num_walls = walls.size();
+
+        // A merge can make a wall reach a fragment it didn't touch before,
+        // so keep sweeping until nothing changes. There are only a few
+        // dozen walls, so the quadratic scan is cheap.
+        bool merged_any = true;
+        while (merged_any) {
+            merged_any = false;
+            for (CountT i = 0; i < num_walls; i++) {
+                for (CountT j = i + 1; j < num_walls; j++) {
+                    if (tryMerge(walls[i], walls[j])) {
+                        walls[j] = walls[--num_walls];
+                        j--;
+                        merged_any = true;
+                    }
+                }
+            }
+        }
+
+        walls.resize(num_walls);
+        horizontal.clear();
+        vertical.clear();
+
+        for (CountT i = 0; i < num_walls; i++) {
+            if (walls[i].isHorizontal()) {
+                horizontal.push_back((uint8_t)i);
+            } else {
+                vertical.push_back((uint8_t)i);
+            }
+        }
+    }
 };
 
 int findAnotherWall(
@@ -483,6 +557,11 @@ CountT populateStaticGeometry(Engine &ctx,
     Walls walls = makeWalls(ctx, rng);
     walls.scale(-level_scale, level_scale);
 
+    if ((ctx.data().simFlags & SimFlags::MergeStaticWalls) ==
+            SimFlags::MergeStaticWalls) {
+        walls.mergeCollinear();
+    }
+
     // Add walls
     for (int i = 0; i < walls.walls.size(); ++i) {
         Wall &wall = walls.walls[i];
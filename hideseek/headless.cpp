@@ -1,15 +1,23 @@
 #include "mgr.hpp"
 
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <chrono>
 #include <string>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <random>
+#include <vector>
+#include <algorithm>
 
 #include "args.hpp"
 #include "dump.hpp"
 
+#include <madrona/cuda_utils.hpp>
+
 #include <stb_image_write.h>
 
 using namespace madrona;
@@ -34,45 +42,150 @@ int main(int argc, char *argv[])
     uint32_t min_seekers = 3;
     uint32_t max_seekers = 3;
 
-    Manager mgr({
-        .execMode = exec_mode,
-        .gpuID = 0,
-        .numWorlds = (uint32_t)num_worlds,
-        .simFlags = SimFlags::Default,
-        .randSeed = 5,
-        .minHiders = min_hiders,
-        .maxHiders = max_hiders,
-        .minSeekers = min_seekers,
-        .maxSeekers = max_seekers,
-        .enableBatchRenderer = enable_batch_renderer,
-        .batchRenderViewWidth = output_resolution,
-        .batchRenderViewHeight = output_resolution,
-        .raycastOutputResolution = output_resolution,
-        .headlessMode = true
-    });
-
-    mgr.init();
-
-    auto start = std::chrono::system_clock::now();
+    SimFlags sim_flags = SimFlags::Default;
 
-    for (CountT i = 0; i < (CountT)num_steps; i++) {
-        mgr.step();
+    const char *merge_walls_str = getenv("HIDESEEK_MERGE_WALLS");
+    if (merge_walls_str && merge_walls_str[0] == '1') {
+        sim_flags |= SimFlags::MergeStaticWalls;
     }
 
-    if (args.dumpOutputFile) {
-        run::dumpTiledImage({
-            .outputPath = args.outputFileName,
-            .gpuTensor = (void *)mgr.raycastTensor().devicePtr(),
-            .numImages = (uint32_t)((min_hiders + min_seekers) * num_worlds),
-            .imageResolution = output_resolution,
-            .colorType = run::ColorType::RGB
+    uint32_t num_physics_substeps = 4;
+    const char *substeps_str = getenv("HIDESEEK_SUBSTEPS");
+    if (substeps_str) {
+        char *end;
+        long substeps = strtol(substeps_str, &end, 10);
+        if (end == substeps_str || *end != '\0' ||
+                substeps < 1 || substeps > INT32_MAX) {
+            fprintf(stderr, "HIDESEEK_SUBSTEPS must be a positive integer\n");
+            return 1;
+        }
+
+        num_physics_substeps = (uint32_t)substeps;
+    }
+
+    // The physics diagnostics only run in the Eval graph, so they are
+    // collected in a separate, untimed pass after the Train graph is timed
+    const char *physics_stats_str = getenv("HIDESEEK_PHYSICS_STATS");
+    bool physics_stats = physics_stats_str && physics_stats_str[0] == '1';
+
+    PhysicsSolver physics_solver = PhysicsSolver::XPBD;
+    const char *solver_str = getenv("HIDESEEK_SOLVER");
+    if (solver_str) {
+        if (!strcmp(solver_str, "xpbd")) {
+            physics_solver = PhysicsSolver::XPBD;
+        } else if (!strcmp(solver_str, "tgs")) {
+            physics_solver = PhysicsSolver::TGS;
+        } else {
+            fprintf(stderr, "HIDESEEK_SOLVER must be xpbd or tgs\n");
+            return 1;
+        }
+    }
+
+    auto makeManager = [&](GraphVariant graph_variant) {
+        return std::make_unique<Manager>(Manager::Config {
+            .execMode = exec_mode,
+            .gpuID = 0,
+            .numWorlds = (uint32_t)num_worlds,
+            .simFlags = sim_flags,
+            .randSeed = 5,
+            .minHiders = min_hiders,
+            .maxHiders = max_hiders,
+            .minSeekers = min_seekers,
+            .maxSeekers = max_seekers,
+            .enableBatchRenderer = enable_batch_renderer,
+            .batchRenderViewWidth = output_resolution,
+            .batchRenderViewHeight = output_resolution,
+            .raycastOutputResolution = output_resolution,
+            .headlessMode = true,
+            .graphVariant = graph_variant,
+            .numPhysicsSubsteps = num_physics_substeps,
+            .physicsSolver = physics_solver,
         });
+    };
+
+    {
+        std::unique_ptr<Manager> mgr = makeManager(GraphVariant::Train);
+        mgr->init();
+
+        auto start = std::chrono::system_clock::now();
+
+        for (CountT i = 0; i < (CountT)num_steps; i++) {
+            mgr->step();
+        }
+
+        if (args.dumpOutputFile) {
+            run::dumpTiledImage({
+                .outputPath = args.outputFileName,
+                .gpuTensor = (void *)mgr->raycastTensor().devicePtr(),
+                .numImages = (uint32_t)((min_hiders + min_seekers) * num_worlds),
+                .imageResolution = output_resolution,
+                .colorType = run::ColorType::RGB
+            });
+        }
+
+        auto end = std::chrono::system_clock::now();
+        std::chrono::duration<double> elapsed = end - start;
+
+        float fps = (double)num_steps * (double)num_worlds / elapsed.count();
+        printf("FPS %f (Train graph)\n", fps);
+        printf("Average step time: %f ms\n", 1000.0f * elapsed.count() / (double)num_steps);
+    }
+
+    if (!physics_stats) {
+        return 0;
+    }
+
+    std::unique_ptr<Manager> mgr = makeManager(GraphVariant::Eval);
+    mgr->init();
+
+    // Idle agents (bucket 5 is zero force and torque, no grab or lock), so
+    // the energy gain only measures solver drift
+    std::vector<int32_t> neutral_actions(
+        num_worlds * (max_hiders + max_seekers) * 5);
+    for (size_t i = 0; i < neutral_actions.size(); i += 5) {
+        neutral_actions[i] = 5;
+        neutral_actions[i + 1] = 5;
+        neutral_actions[i + 2] = 5;
+    }
+
+    cudaMemcpy(mgr->actionTensor().devicePtr(), neutral_actions.data(),
+               sizeof(int32_t) * neutral_actions.size(),
+               cudaMemcpyHostToDevice);
+
+    for (CountT i = 0; i < (CountT)num_steps; i++) {
+        mgr->step();
     }
 
-    auto end = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed = end - start;
+    // [numWorlds, 2]: total steps, quiescent steps
+    std::vector<int32_t> activity(num_worlds * 2);
+    cudaMemcpy(activity.data(), mgr->physicsActivityTensor().devicePtr(),
+               sizeof(int32_t) * activity.size(), cudaMemcpyDeviceToHost);
+
+    int64_t total_steps = 0;
+    int64_t quiescent_steps = 0;
+    for (uint64_t i = 0; i < num_worlds; i++) {
+        total_steps += activity[2 * i];
+        quiescent_steps += activity[2 * i + 1];
+    }
+
+    printf("Physics substeps: %u, quiescent world steps: %.1f%%\n",
+           num_physics_substeps,
+           100.0 * (double)quiescent_steps / (double)std::max(total_steps,
+                                                              (int64_t)1));
+
+    // [numWorlds, 2]: max penetration, max energy gain
+    std::vector<float> stability(num_worlds * 2);
+    cudaMemcpy(stability.data(), mgr->physicsStabilityTensor().devicePtr(),
+               sizeof(float) * stability.size(), cudaMemcpyDeviceToHost);
+
+    float max_penetration = 0.f;
+    float max_energy_gain = 0.f;
+    for (uint64_t i = 0; i < num_worlds; i++) {
+        max_penetration = std::max(max_penetration, stability[2 * i]);
+        max_energy_gain = std::max(max_energy_gain, stability[2 * i + 1]);
+    }
 
-    float fps = (double)num_steps * (double)num_worlds / elapsed.count();
-    printf("FPS %f\n", fps);
-    printf("Average step time: %f ms\n", 1000.0f * elapsed.count() / (double)num_steps);
+    printf("Solver %s: max penetration %f m, max energy gain %f J\n",
+           physics_solver == PhysicsSolver::XPBD ? "xpbd" : "tgs",
+           max_penetration, max_energy_gain);
 }
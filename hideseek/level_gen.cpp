@@ -11,14 +11,28 @@ using namespace madrona::phys;
 
 static Entity makeAgent(Engine &ctx, AgentType agent_type)
 {
-    Entity agent_iface =
-        ctx.data().agentInterfaces[ctx.data().numActiveAgents++];
+    CountT agent_slot = ctx.data().numActiveAgents++;
+    Entity agent_iface = ctx.data().agentInterfaces[agent_slot];
     ctx.get<AgentType>(agent_iface) = agent_type;
 
     Entity agent = ctx.makeRenderableEntity<DynAgent>();
     // Entity agent = ctx.makeEntity<DynAgent>();
     ctx.get<SimEntity>(agent_iface).e = agent;
 
+    Entity &grab_joint = ctx.data().grabJoints[agent_slot];
+    if (grab_joint == Entity::none()) {
+        grab_joint = PhysicsSystem::makeFixedJoint(ctx, agent, agent,
+            Quat { 1, 0, 0, 0 }, Quat { 1, 0, 0, 0 },
+            Vector3::zero(), Vector3::zero(), 0.f);
+    } else {
+        ctx.parkGrabJoint(grab_joint, agent);
+    }
+
+    ctx.get<GrabData>(agent) = GrabData {
+        .constraintEntity = grab_joint,
+        .grabbedEntity = Entity::none(),
+    };
+
     ctx.get<AgentActiveMask>(agent_iface).mask = 1.f;
 
     if (agent_type == AgentType::Seeker) {
@@ -228,7 +242,6 @@ static void generateTrainingEnvironment(Engine &ctx,
         ctx.get<OwnerTeam>(agent) = OwnerTeam::Unownable;
         ctx.get<ExternalForce>(agent) = Vector3::zero();
         ctx.get<ExternalTorque>(agent) = Vector3::zero();
-        ctx.get<GrabData>(agent).constraintEntity = Entity::none();
 
         return agent;
     };
@@ -316,6 +329,15 @@ void generateEnvironment(Engine &ctx,
 
         ctx.get<SimEntity>(agent_iface).e = Entity::none();
         ctx.get<AgentActiveMask>(agent_iface).mask = 0.f;
+
+        // The joint of an unused slot still references last episode's
+        // agent, so it can't stay in the solver. This only happens when
+        // the agent count changes between episodes.
+        Entity &grab_joint = ctx.data().grabJoints[i];
+        if (grab_joint != Entity::none()) {
+            ctx.destroyEntity(grab_joint);
+            grab_joint = Entity::none();
+        }
     }
 }
 
@@ -405,7 +427,6 @@ static void level5(Engine &ctx)
         ctx.get<OwnerTeam>(agent) = OwnerTeam::Unownable;
         ctx.get<ExternalForce>(agent) = Vector3::zero();
         ctx.get<ExternalTorque>(agent) = Vector3::zero();
-        ctx.get<GrabData>(agent).constraintEntity = Entity::none();
 
         return agent;
     };
@@ -449,7 +470,6 @@ static void level6(Engine &ctx)
         ctx.get<OwnerTeam>(agent) = OwnerTeam::Unownable;
         ctx.get<ExternalForce>(agent) = Vector3::zero();
         ctx.get<ExternalTorque>(agent) = Vector3::zero();
-        ctx.get<GrabData>(agent).constraintEntity = Entity::none();
 
         return agent;
     };
@@ -385,13 +385,32 @@ static imp::ImportedAssets loadRenderObjects(
 
 Manager::Impl * Manager::Impl::make(const Config &cfg)
 {
+    // The Train graph compiles out the runtime flag handling, so passing
+    // these would silently do nothing
+    SimFlags runtime_flags = cfg.simFlags &
+        (SimFlags::UseFixedWorld | SimFlags::IgnoreEpisodeLength);
+    if (cfg.graphVariant == GraphVariant::Train &&
+            runtime_flags != SimFlags::Default) {
+        FATAL("UseFixedWorld / IgnoreEpisodeLength need the Eval or Debug "
+              "graph variant, Train ignores them");
+    }
+
+    if (cfg.numPhysicsSubsteps < 1 ||
+            cfg.numPhysicsSubsteps > (uint32_t)INT32_MAX) {
+        FATAL("numPhysicsSubsteps must be at least 1, got %u",
+              cfg.numPhysicsSubsteps);
+    }
+
     GPUHideSeek::Config app_cfg;
     app_cfg.simFlags = cfg.simFlags;
+    app_cfg.graphVariant = cfg.graphVariant;
     app_cfg.initRandKey = rand::initKey(cfg.randSeed);
     app_cfg.minHiders = cfg.minHiders;
     app_cfg.maxHiders = cfg.maxHiders;
     app_cfg.minSeekers = cfg.minSeekers;
     app_cfg.maxSeekers = cfg.maxSeekers;
+    app_cfg.numPhysicsSubsteps = (int32_t)cfg.numPhysicsSubsteps;
+    app_cfg.physicsSolver = cfg.physicsSolver;
 
     int32_t max_agents_per_world = cfg.maxHiders + cfg.maxSeekers;
 
@@ -809,6 +828,26 @@ madrona::py::Tensor Manager::seedTensor() const
         });
 }
 
+madrona::py::Tensor Manager::physicsActivityTensor() const
+{
+    return impl_->exportStateTensor(
+        ExportID::PhysicsActivity, TensorElementType::Int32,
+        {
+            impl_->cfg.numWorlds,
+            sizeof(PhysicsActivity) / sizeof(int32_t),
+        });
+}
+
+madrona::py::Tensor Manager::physicsStabilityTensor() const
+{
+    return impl_->exportStateTensor(
+        ExportID::PhysicsStability, TensorElementType::Float32,
+        {
+            impl_->cfg.numWorlds,
+            sizeof(PhysicsStability) / sizeof(float),
+        });
+}
+
 madrona::py::Tensor Manager::globalPositionsTensor() const
 {
     return impl_->exportStateTensor(
@@ -30,6 +30,9 @@ public:
         madrona::render::GPUDevice *extRenderDev = nullptr;
         uint32_t raycastOutputResolution = 64;
         bool headlessMode = false;
+        GraphVariant graphVariant = GraphVariant::Debug;
+        uint32_t numPhysicsSubsteps = 4;
+        PhysicsSolver physicsSolver = PhysicsSolver::XPBD;
     };
 
     Manager(const Config &cfg);
@@ -54,6 +57,9 @@ public:
     madrona::py::Tensor globalPositionsTensor() const;
     madrona::py::Tensor lidarTensor() const;
     madrona::py::Tensor seedTensor() const;
+    // Only updated by the Eval and Debug graph variants
+    madrona::py::Tensor physicsActivityTensor() const;
+    madrona::py::Tensor physicsStabilityTensor() const;
 
     madrona::py::Tensor depthTensor() const;
     madrona::py::Tensor rgbTensor() const;
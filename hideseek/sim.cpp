@@ -12,17 +12,26 @@ namespace RenderingSystem = madrona::render::RenderingSystem;
 namespace GPUHideSeek {
 
 constexpr inline float deltaT = 1.f / 30.f;
-constexpr inline CountT numPhysicsSubsteps = 4;
 constexpr inline CountT numPrepSteps = 96;
 constexpr inline CountT episodeLen = 240;
+// Worlds where no dynamic body moves faster than this (m/s) count as
+// quiescent in PhysicsActivity.
+constexpr inline float quiescentSpeed = 0.1f;
 
-constexpr inline auto physicsSolverSelector = PhysicsSystem::Solver::XPBD;
+static inline PhysicsSystem::Solver physicsSolverSelector(const Config &cfg)
+{
+    switch (cfg.physicsSolver) {
+    case PhysicsSolver::XPBD: return PhysicsSystem::Solver::XPBD;
+    case PhysicsSolver::TGS: return PhysicsSystem::Solver::TGS;
+    default: MADRONA_UNREACHABLE();
+    }
+}
 
 void Sim::registerTypes(ECSRegistry &registry,
                         const Config &cfg)
 {
     base::registerTypes(registry);
-    PhysicsSystem::registerTypes(registry, physicsSolverSelector);
+    PhysicsSystem::registerTypes(registry, physicsSolverSelector(cfg));
 
     RenderingSystem::registerTypes(registry, cfg.renderBridge);
 
@@ -50,6 +59,8 @@ void Sim::registerTypes(ECSRegistry &registry,
     registry.registerSingleton<GlobalDebugPositions>();
     registry.registerSingleton<LoadCheckpoint>();
     registry.registerSingleton<Checkpoint>();
+    registry.registerSingleton<PhysicsActivity>();
+    registry.registerSingleton<PhysicsStability>();
 
     registry.registerArchetype<DynamicObject>();
     registry.registerArchetype<AgentInterface>();
@@ -83,15 +94,33 @@ void Sim::registerTypes(ECSRegistry &registry,
     registry.exportColumn<AgentInterface, Done>(ExportID::Done);
     registry.exportSingleton<GlobalDebugPositions>(
         ExportID::GlobalDebugPositions);
+    registry.exportSingleton<PhysicsActivity>(
+        ExportID::PhysicsActivity);
+    registry.exportSingleton<PhysicsStability>(
+        ExportID::PhysicsStability);
     registry.exportColumn<render::RaycastOutputArchetype,
         render::RGBOutputBuffer>(
             (uint32_t)ExportID::Raycast);
 }
 
+// The training graph never honors the UseFixedWorld / IgnoreEpisodeLength
+// debug flags or checkpoint loading, so those branches are compiled out of
+// its systems entirely.
+static constexpr bool variantHasRuntimeFlags(GraphVariant variant)
+{
+    return variant != GraphVariant::Train;
+}
+
+template <GraphVariant variant>
 static void initEpisodeRNG(Engine &ctx)
 {
     RandKey new_rnd_counter;
-    if ((ctx.data().simFlags & SimFlags::UseFixedWorld) ==
+    if constexpr (!variantHasRuntimeFlags(variant)) {
+        new_rnd_counter = {
+            .a = ctx.data().curWorldEpisode++,
+            .b = (uint32_t)ctx.worldID().idx,
+        };
+    } else if ((ctx.data().simFlags & SimFlags::UseFixedWorld) ==
             SimFlags::UseFixedWorld) {
         new_rnd_counter = { 0, 0 };
     } else {
@@ -112,6 +141,7 @@ static void initEpisodeRNG(Engine &ctx)
         new_rnd_counter.a, new_rnd_counter.b));
 }
 
+template <GraphVariant variant>
 static inline void resetEnvironment(Engine &ctx)
 {
     ctx.data().curEpisodeStep = 0;
@@ -127,46 +157,44 @@ static inline void resetEnvironment(Engine &ctx)
     ctx.data().numActiveBoxes = 0;
     ctx.data().numActiveRamps = 0;
 
-    auto destroyAgent = [&](Entity e) {
-        auto grab_data = ctx.getSafe<GrabData>(e);
-
-        if (grab_data.valid()) {
-            auto constraint_entity = grab_data.value().constraintEntity;
-            if (constraint_entity != Entity::none()) {
-                ctx.destroyEntity(constraint_entity);
-            }
-        }
-
-        ctx.destroyRenderableEntity(e);
-    };
-
+    // Grab joints are kept in Sim::grabJoints and re-targeted onto the new
+    // agents by generateEnvironment, so only the bodies are destroyed here.
     for (CountT i = 0; i < ctx.data().numHiders; i++) {
-        destroyAgent(ctx.data().hiders[i]);
+        ctx.destroyRenderableEntity(ctx.data().hiders[i]);
     }
     ctx.data().numHiders = 0;
 
     for (CountT i = 0; i < ctx.data().numSeekers; i++) {
-        destroyAgent(ctx.data().seekers[i]);
+        ctx.destroyRenderableEntity(ctx.data().seekers[i]);
     }
     ctx.data().numSeekers = 0;
 
     ctx.data().numActiveAgents = 0;
 
-    initEpisodeRNG(ctx);
+    initEpisodeRNG<variant>(ctx);
 }
 
+template <GraphVariant variant>
 inline void resetSystem(Engine &ctx, WorldReset &reset)
 {
     int32_t level = reset.resetLevel;
 
-    if ((ctx.data().simFlags & SimFlags::IgnoreEpisodeLength) !=
-                SimFlags::IgnoreEpisodeLength &&
+    bool ignore_episode_length;
+    if constexpr (variantHasRuntimeFlags(variant)) {
+        ignore_episode_length =
+            (ctx.data().simFlags & SimFlags::IgnoreEpisodeLength) ==
+                SimFlags::IgnoreEpisodeLength;
+    } else {
+        ignore_episode_length = false;
+    }
+
+    if (!ignore_episode_length &&
             ctx.data().curEpisodeStep == episodeLen - 1) {
         level = 1;
     }
 
     if (level != 0) {
-        resetEnvironment(ctx);
+        resetEnvironment<variant>(ctx);
 
         reset.resetLevel = 0;
 
@@ -259,9 +287,9 @@ inline void actionSystem(Engine &ctx,
 
         auto &grab_data = ctx.get<GrabData>(sim_e.e);
 
-        if (grab_data.constraintEntity != Entity::none()) {
-            ctx.destroyEntity(grab_data.constraintEntity);
-            grab_data.constraintEntity = Entity::none();
+        if (grab_data.grabbedEntity != Entity::none()) {
+            ctx.parkGrabJoint(grab_data.constraintEntity, sim_e.e);
+            grab_data.grabbedEntity = Entity::none();
         } else {
             auto &bvh = ctx.singleton<broadphase::BVH>();
             float hit_t;
@@ -294,9 +322,10 @@ inline void actionSystem(Engine &ctx,
 
                     float separation = hit_t - 1.25f;
 
-                    grab_data.constraintEntity = PhysicsSystem::makeFixedJoint(
-                        ctx, sim_e.e, grab_entity, attach1, attach2,
+                    ctx.setGrabJoint(grab_data.constraintEntity,
+                        sim_e.e, grab_entity, attach1, attach2,
                         r1, r2, separation);
+                    grab_data.grabbedEntity = grab_entity;
 
                 }
             }
@@ -753,6 +782,96 @@ inline void globalPositionsDebugSystem(Engine &ctx,
     }
 }
 
+inline void physicsActivitySystem(Engine &ctx,
+                                  PhysicsActivity &activity)
+{
+    float max_speed_sq = 0.f;
+    auto checkSpeed = [&](Entity e) {
+        Vector3 v = ctx.get<Velocity>(e).linear;
+        max_speed_sq = fmaxf(max_speed_sq, v.length2());
+    };
+
+    for (CountT i = 0; i < ctx.data().numActiveBoxes; i++) {
+        checkSpeed(ctx.data().boxes[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numActiveRamps; i++) {
+        checkSpeed(ctx.data().ramps[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numHiders; i++) {
+        checkSpeed(ctx.data().hiders[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numSeekers; i++) {
+        checkSpeed(ctx.data().seekers[i]);
+    }
+
+    activity.numSteps += 1;
+    if (max_speed_sq < quiescentSpeed * quiescentSpeed) {
+        activity.numQuiescentSteps += 1;
+    }
+}
+
+inline void physicsStabilitySystem(Engine &ctx,
+                                   PhysicsStability &stability)
+{
+    const ObjectManager &obj_mgr = *ctx.singleton<ObjectData>().mgr;
+
+    float energy = 0.f;
+    float max_penetration = 0.f;
+    auto accumulate = [&](Entity e) {
+        if (ctx.get<ResponseType>(e) != ResponseType::Dynamic) {
+            return;
+        }
+
+        ObjectID obj_id = ctx.get<ObjectID>(e);
+        const RigidBodyMetadata &metadata = obj_mgr.metadata[obj_id.idx];
+        if (metadata.mass.invMass == 0.f) {
+            return;
+        }
+
+        Vector3 pos = ctx.get<Position>(e);
+        Vector3 vel = ctx.get<Velocity>(e).linear;
+        float mass = 1.f / metadata.mass.invMass;
+        energy += 0.5f * mass * vel.length2() + mass * 9.8f * pos.z;
+
+        // Bodies mostly rotate about the up axis, for which the
+        // transformed AABB's lowest point is exact.
+        AABB aabb = obj_mgr.rigidBodyAABBs[obj_id.idx].applyTRS(
+            pos, ctx.get<Rotation>(e), Diag3x3(ctx.get<Scale>(e)));
+        max_penetration = fmaxf(max_penetration, -aabb.pMin.z);
+    };
+
+    for (CountT i = 0; i < ctx.data().numActiveBoxes; i++) {
+        accumulate(ctx.data().boxes[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numActiveRamps; i++) {
+        accumulate(ctx.data().ramps[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numHiders; i++) {
+        accumulate(ctx.data().hiders[i]);
+    }
+
+    for (CountT i = 0; i < ctx.data().numSeekers; i++) {
+        accumulate(ctx.data().seekers[i]);
+    }
+
+    // Agent actions inject energy too (any bucket but 5 applies force), so
+    // the gain only measures solver drift when agents are idle, as in the
+    // headless benchmark's stats pass, which writes neutral actions.
+    if (ctx.data().curEpisodeStep == 0) {
+        ctx.data().episodeStartEnergy = energy;
+    }
+
+    stability.maxPenetration =
+        fmaxf(stability.maxPenetration, max_penetration);
+    stability.maxEnergyGain = fmaxf(stability.maxEnergyGain,
+        energy - ctx.data().episodeStartEnergy);
+}
+
 inline void updateCameraSystem(Engine &ctx,
                                Position &pos,
                                Rotation &rot,
@@ -781,36 +900,65 @@ TaskGraph::NodeID queueSortByWorld(TaskGraphBuilder &builder,
 }
 #endif
 
-static TaskGraphNodeID processActionsAndPhysicsTasks(TaskGraphBuilder &builder)
+template <GraphVariant variant>
+static TaskGraphNodeID processActionsAndPhysicsTasks(TaskGraphBuilder &builder,
+                                                     const Config &cfg)
 {
     auto move_sys = builder.addToGraph<ParallelForNode<Engine, movementSystem,
         Action, SimEntity, AgentType>>({});
 
-    auto broadphase_setup_sys = phys::PhysicsSystem::setupBroadphaseTasks(builder,
-        {move_sys});
-
+    // No broadphase update here: the BVH was already refit at the end of the
+    // previous step (or by the init graph) by the post-reset broadphase in
+    // resetTasks, and movementSystem only writes forces, so every leaf is
+    // still current for actionSystem's raycasts and the physics step.
+    //
+    // Static walls and the plane are still refit with the dynamic bodies
+    // in that single pass. Keeping them in a separate BVH built at reset
+    // needs a second structure in madrona's broadphase, which narrowphase
+    // and traceRay would both have to consult.
     auto action_sys = builder.addToGraph<ParallelForNode<Engine, actionSystem,
-        Action, SimEntity, AgentType>>({broadphase_setup_sys});
+        Action, SimEntity, AgentType>>({move_sys});
 
     auto substep_sys = PhysicsSystem::setupPhysicsStepTasks(builder,
-        {action_sys}, numPhysicsSubsteps, physicsSolverSelector);
+        {action_sys}, cfg.numPhysicsSubsteps, physicsSolverSelector(cfg));
 
     auto sim_done = substep_sys;
 
     sim_done = phys::PhysicsSystem::setupCleanupTasks(
         builder, {sim_done});
 
+    // Diagnostics only, the training graph leaves the counters at zero
+    if constexpr (variant != GraphVariant::Train) {
+        sim_done = builder.addToGraph<ParallelForNode<Engine,
+            physicsActivitySystem,
+                PhysicsActivity
+            >>({sim_done});
+
+        sim_done = builder.addToGraph<ParallelForNode<Engine,
+            physicsStabilitySystem,
+                PhysicsStability
+            >>({sim_done});
+    }
+
     return sim_done;
 }
 
+template <GraphVariant variant>
 static TaskGraphNodeID rewardsAndDonesTasks(TaskGraphBuilder &builder,
                                             Span<const TaskGraphNodeID> deps)
 {
-    auto rewards_vis = builder.addToGraph<ParallelForNode<Engine,
-        rewardsVisSystem,
-            SimEntity,
-            AgentType
-        >>(deps);
+    // rewardsVisSystem is currently disabled; only schedule it in the
+    // debug graph so the other variants don't pay for an empty dispatch.
+    TaskGraphNodeID rewards_deps[1];
+    Span<const TaskGraphNodeID> output_deps = deps;
+    if constexpr (variant == GraphVariant::Debug) {
+        rewards_deps[0] = builder.addToGraph<ParallelForNode<Engine,
+            rewardsVisSystem,
+                SimEntity,
+                AgentType
+            >>(deps);
+        output_deps = Span<const TaskGraphNodeID>(rewards_deps, 1);
+    }
 
     auto output_rewards_dones = builder.addToGraph<ParallelForNode<Engine,
         outputRewardsDonesSystem,
@@ -818,16 +966,17 @@ static TaskGraphNodeID rewardsAndDonesTasks(TaskGraphBuilder &builder,
             AgentType,
             Reward,
             Done
-        >>({rewards_vis});
+        >>(output_deps);
 
     return output_rewards_dones;
 }
 
+template <GraphVariant variant>
 static TaskGraphNodeID resetTasks(TaskGraphBuilder &builder,
                                   Span<const TaskGraphNodeID> deps)
 {
     auto reset_sys = builder.addToGraph<ParallelForNode<Engine,
-        resetSystem, WorldReset>>(deps);
+        resetSystem<variant>, WorldReset>>(deps);
 
     auto clear_tmp = builder.addToGraph<ResetTmpAllocNode>({reset_sys});
 
@@ -850,6 +999,7 @@ static TaskGraphNodeID resetTasks(TaskGraphBuilder &builder,
     return post_reset_broadphase;
 }
 
+template <GraphVariant variant>
 static void observationsTasks(const Config &cfg,
                               TaskGraphBuilder &builder,
                               Span<const TaskGraphNodeID> deps)
@@ -890,10 +1040,12 @@ static void observationsTasks(const Config &cfg,
             Lidar
         >>(deps);
 
-    auto global_positions_debug = builder.addToGraph<ParallelForNode<Engine,
-        globalPositionsDebugSystem,
-            GlobalDebugPositions
-        >>(deps);
+    if constexpr (variant != GraphVariant::Train) {
+        builder.addToGraph<ParallelForNode<Engine,
+            globalPositionsDebugSystem,
+                GlobalDebugPositions
+            >>(deps);
+    }
 
     /* if (cfg.renderBridge) */ {
         auto update_camera = builder.addToGraph<ParallelForNode<Engine,
@@ -909,9 +1061,9 @@ static void observationsTasks(const Config &cfg,
     (void)lidar;
     (void)compute_visibility;
     (void)collect_observations;
-    (void)global_positions_debug;
 }
 
+template <GraphVariant variant>
 static void setupInitTasks(TaskGraphBuilder &builder, const Config &cfg)
 {
 #ifdef MADRONA_GPU_MODE
@@ -920,20 +1072,22 @@ static void setupInitTasks(TaskGraphBuilder &builder, const Config &cfg)
         queueSortByWorld<AgentInterface>(builder, {});
 #endif
 
-    auto resets = resetTasks(builder, {
+    auto resets = resetTasks<variant>(builder, {
 #ifdef MADRONA_GPU_MODE
         sort_agent_iface
 #endif
     });
-    observationsTasks(cfg, builder, {resets});
+    observationsTasks<variant>(cfg, builder, {resets});
 }
 
+template <GraphVariant variant>
 static void setupStepTasks(TaskGraphBuilder &builder, const Config &cfg)
 {
-    auto sim_done = processActionsAndPhysicsTasks(builder);
-    auto rewards_and_dones = rewardsAndDonesTasks(builder, {sim_done});
-    auto resets = resetTasks(builder, {rewards_and_dones});
-    observationsTasks(cfg, builder, {resets});
+    auto sim_done = processActionsAndPhysicsTasks<variant>(builder, cfg);
+    auto rewards_and_dones =
+        rewardsAndDonesTasks<variant>(builder, {sim_done});
+    auto resets = resetTasks<variant>(builder, {rewards_and_dones});
+    observationsTasks<variant>(cfg, builder, {resets});
 }
 
 static void setupRenderTasks(TaskGraphBuilder &builder, 
@@ -942,13 +1096,31 @@ static void setupRenderTasks(TaskGraphBuilder &builder,
     RenderingSystem::setupTasks(builder, {});
 }
 
-void Sim::setupTasks(TaskGraphManager &taskgraph_mgr, const Config &cfg)
+template <GraphVariant variant>
+static void setupVariantTasks(TaskGraphManager &taskgraph_mgr,
+                              const Config &cfg)
 {
-    setupInitTasks(taskgraph_mgr.init(TaskGraphID::Init), cfg);
-    setupStepTasks(taskgraph_mgr.init(TaskGraphID::Step), cfg);
+    setupInitTasks<variant>(taskgraph_mgr.init(TaskGraphID::Init), cfg);
+    setupStepTasks<variant>(taskgraph_mgr.init(TaskGraphID::Step), cfg);
     setupRenderTasks(taskgraph_mgr.init(TaskGraphID::Render), cfg);
 }
 
+void Sim::setupTasks(TaskGraphManager &taskgraph_mgr, const Config &cfg)
+{
+    switch (cfg.graphVariant) {
+    case GraphVariant::Train: {
+        setupVariantTasks<GraphVariant::Train>(taskgraph_mgr, cfg);
+    } break;
+    case GraphVariant::Eval: {
+        setupVariantTasks<GraphVariant::Eval>(taskgraph_mgr, cfg);
+    } break;
+    case GraphVariant::Debug: {
+        setupVariantTasks<GraphVariant::Debug>(taskgraph_mgr, cfg);
+    } break;
+    default: MADRONA_UNREACHABLE();
+    }
+}
+
 Sim::Sim(Engine &ctx,
          const Config &cfg,
          const WorldInit &)
@@ -963,8 +1135,8 @@ Sim::Sim(Engine &ctx,
         consts::maxAgents + 30;
 
     PhysicsSystem::init(ctx, cfg.rigidBodyObjMgr, deltaT,
-         numPhysicsSubsteps, -9.8 * math::up, max_total_entities,
-         physicsSolverSelector);
+         cfg.numPhysicsSubsteps, -9.8 * math::up, max_total_entities,
+         physicsSolverSelector(cfg));
 
     // enableRender = cfg.renderBridge != nullptr;
     enableRender = true;
@@ -999,7 +1171,20 @@ Sim::Sim(Engine &ctx,
         .load = 0,
     };
 
+    ctx.singleton<PhysicsActivity>() = {
+        .numSteps = 0,
+        .numQuiescentSteps = 0,
+    };
+
+    ctx.singleton<PhysicsStability>() = {
+        .maxPenetration = 0.f,
+        .maxEnergyGain = 0.f,
+    };
+    episodeStartEnergy = 0.f;
+
     for (CountT i = 0; i < (CountT)maxAgentsPerWorld; i++) {
+        grabJoints[i] = Entity::none();
+
         Entity agent_iface = agentInterfaces[i] =
             ctx.makeEntity<AgentInterface>();
 
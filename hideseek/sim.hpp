@@ -58,6 +58,8 @@ enum class ExportID : uint32_t { // Base requirements
     Reward,
     Done,
     GlobalDebugPositions,
+    PhysicsActivity,
+    PhysicsStability,
     Raycast,
     NumExports,
 };
@@ -82,11 +84,14 @@ enum class SimObject : uint32_t {
 
 struct Config {
     SimFlags simFlags;
+    GraphVariant graphVariant;
     RandKey initRandKey;
     int32_t minHiders;
     int32_t maxHiders;
     int32_t minSeekers;
     int32_t maxSeekers;
+    int32_t numPhysicsSubsteps;
+    PhysicsSolver physicsSolver;
     madrona::phys::ObjectManager *rigidBodyObjMgr;
     const madrona::render::RenderECSBridge *renderBridge;
 };
@@ -109,7 +114,10 @@ enum class OwnerTeam : uint32_t {
 };
 
 struct GrabData {
+    // Pooled fixed joint of this agent's slot (see Sim::grabJoints). It is
+    // parked as a no-op self joint while nothing is held.
     Entity constraintEntity;
+    Entity grabbedEntity;
 };
 
 enum class AgentType : uint32_t {
@@ -145,6 +153,22 @@ struct GlobalDebugPositions {
     Vector2 agentPositions[consts::maxAgents];
 };
 
+// Running per-world counters of how many steps had every dynamic body
+// close to rest, i.e. steps that wouldn't need full physics substepping.
+struct PhysicsActivity {
+    int32_t numSteps;
+    int32_t numQuiescentSteps;
+};
+
+// Simple solver stability measures, tracked as maxima over all steps:
+// how far any dynamic body's lowest point sank below the ground plane, and
+// how much kinetic + potential energy the world gained relative to the
+// start of the episode.
+struct PhysicsStability {
+    float maxPenetration;
+    float maxEnergyGain;
+};
+
 struct AgentObservation {
     Vector2 pos;
     Vector2 vel;
@@ -265,6 +289,9 @@ struct Sim : public madrona::WorldBase {
     RNG rng;
 
     Entity agentInterfaces[consts::maxAgents];
+    // One fixed joint per agent slot, created the first time the slot is
+    // used and re-parameterized in place on grab / release / reset.
+    Entity grabJoints[consts::maxAgents];
 
     Entity hiders[3];
     int32_t numHiders;
@@ -283,6 +310,7 @@ struct Sim : public madrona::WorldBase {
     CountT numActiveRamps;
 
     CountT curEpisodeStep;
+    float episodeStartEnergy;
 
     bool enableRender;
 
@@ -304,6 +332,16 @@ public:
     template <typename ArchetypeT>
     inline madrona::Entity makeRenderableEntity();
     inline void destroyRenderableEntity(Entity e);
+
+    // Re-target a pooled grab joint. parkGrabJoint attaches the joint to
+    // a single body at coincident points, which both solvers treat as
+    // already satisfied (see sim.inl), effectively disabling it.
+    inline void setGrabJoint(Entity joint,
+                             Entity e1, Entity e2,
+                             Quat attach1, Quat attach2,
+                             Vector3 r1, Vector3 r2,
+                             float separation);
+    inline void parkGrabJoint(Entity joint, Entity agent);
 };
 
 }
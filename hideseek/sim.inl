@@ -19,4 +19,34 @@ inline void Engine::destroyRenderableEntity(Entity e)
     destroyEntity(e);
 }
 
+inline void Engine::setGrabJoint(Entity joint,
+                                 Entity e1, Entity e2,
+                                 Quat attach1, Quat attach2,
+                                 Vector3 r1, Vector3 r2,
+                                 float separation)
+{
+    get<madrona::phys::JointConstraint>(joint) =
+        madrona::phys::JointConstraint::setupFixed(
+            e1, e2, attach1, attach2, r1, r2, separation);
+}
+
+// JointConstraint has no enabled flag, so a parked joint stays in the
+// solver, and this relies on it contributing nothing there:
+// - XPBD: both anchors are the same point of the same body and separation
+//   is 0, so the positional error is 0. attach1 == attach2, so the
+//   rotational error is 0 too. Each substep computes a zero correction.
+// - TGS: the relative velocity at coincident anchors of one body is
+//   identically 0, and there is no position error to bias, so the solved
+//   impulse is 0.
+// The remaining cost is evaluating one such constraint per agent slot
+// (maxAgents per world at most) per solver iteration. That is small
+// compared to the contacts, and cheaper than the entity churn of
+// destroying and recreating the joint on every release.
+inline void Engine::parkGrabJoint(Entity joint, Entity agent)
+{
+    setGrabJoint(joint, agent, agent,
+                 Quat { 1, 0, 0, 0 }, Quat { 1, 0, 0, 0 },
+                 Vector3::zero(), Vector3::zero(), 0.f);
+}
+
 }
@@ -8,6 +8,26 @@ enum class SimFlags : uint32_t {
     Default                = 0,
     UseFixedWorld          = 1 << 0,
     IgnoreEpisodeLength    = 1 << 1,
+    MergeStaticWalls       = 1 << 2, // Fuse collinear maze walls into one
+                                     // static body per segment
+};
+
+// Selects which specialization of the step graph is built at Manager
+// construction. Train drops debug-only systems and compiles out the
+// runtime SimFlags / checkpoint branches. Eval keeps the flag handling and
+// the global position export. Debug keeps every system.
+enum class GraphVariant : uint32_t {
+    Train,
+    Eval,
+    Debug,
+};
+
+// Constraint solver used by the physics step. Mirrors
+// madrona::phys::PhysicsSystem::Solver so the Manager interface doesn't need
+// the physics headers.
+enum class PhysicsSolver : uint32_t {
+    XPBD,
+    TGS,
 };
 
 inline SimFlags & operator|=(SimFlags &a, SimFlags b);
@@ -0,0 +1,68 @@
+import argparse
+import math
+import random
+import struct
+import sys
+from array import array
+
+# Writes a camera trajectory file for MADRONA_CAMERA_TRAJECTORY (see
+# common/camera_trajectory.hpp). Each camera orbits the scene center like
+# the habitat dynamic movement, but with a fixed, seeded phase instead of
+# per-step random jitter, so every run renders the same views.
+
+MAGIC = b'MADCTRAJ'
+VERSION = 1
+
+arg_parser = argparse.ArgumentParser()
+arg_parser.add_argument('--output', type=str, required=True)
+arg_parser.add_argument('--num-trajectories', type=int, default=1,
+                        help='worlds cycle through these')
+arg_parser.add_argument('--num-views', type=int, default=1,
+                        help='cameras per world (HIDESEEK_NUM_AGENTS)')
+arg_parser.add_argument('--num-steps', type=int, required=True)
+arg_parser.add_argument('--radius', type=float, default=20.0)
+arg_parser.add_argument('--height', type=float, default=15.0)
+arg_parser.add_argument('--height-amplitude', type=float, default=3.0)
+arg_parser.add_argument('--time-step', type=float, default=0.05)
+arg_parser.add_argument('--yaw-step', type=float, default=0.15)
+arg_parser.add_argument('--pitch', type=float, default=-0.33)
+arg_parser.add_argument('--seed', type=int, default=0)
+
+args = arg_parser.parse_args()
+
+rng = random.Random(args.seed)
+
+def wrap_angle(a):
+    return (a + math.pi) % (2.0 * math.pi) - math.pi
+
+# Poses are [trajectory][view][step], 5 floats each
+poses = array('f')
+for _ in range(args.num_trajectories):
+    trajectory_phase = rng.uniform(0.0, 2.0 * math.pi)
+
+    for view in range(args.num_views):
+        # Views of a world are spread evenly around the orbit
+        phase = trajectory_phase + 2.0 * math.pi * view / args.num_views
+
+        for step in range(args.num_steps):
+            t = phase + args.time_step * step
+
+            poses.extend([
+                args.radius * math.cos(t),
+                args.radius * math.sin(t),
+                args.height + args.height_amplitude * math.sin(t),
+                wrap_angle(phase + args.yaw_step * step),
+                args.pitch,
+            ])
+
+if sys.byteorder != 'little':
+    poses.byteswap()
+
+with open(args.output, 'wb') as f:
+    f.write(MAGIC)
+    f.write(struct.pack('<IIIIQ', VERSION, args.num_trajectories,
+                        args.num_views, args.num_steps, 0))
+    poses.tofile(f)
+
+print(f'Wrote {args.num_trajectories} x {args.num_views} x {args.num_steps} '
+      f'poses to {args.output}')
@@ -0,0 +1,36 @@
+#!/bin/bash
+# Sweeps the number of GLB copies per world in glb_headless, reporting init
+# time, memory and throughput for each count.
+# Run from the build/ directory:
+#   ../scripts/glb_instance_bench.sh GLB_PATH [NUM_WORLDS] [NUM_STEPS] [rt|rast] [RES]
+#
+# GLB_PATH is relative to data/. GRIDS (default "1 2 4 8 16 32") overrides
+# the N of the swept NxN grids; RANDOM_PLACEMENT=1 places N*N copies at random
+# positions instead.
+
+GLB_PATH=$1
+NUM_WORLDS=${2:-1024}
+NUM_STEPS=${3:-1000}
+RENDER_MODE=${4:-rt}
+RES=${5:-64}
+
+GRIDS=${GRIDS:-"1 2 4 8 16 32"}
+
+if [ -z "${GLB_PATH}" ]; then
+    echo "Usage: $0 GLB_PATH [NUM_WORLDS] [NUM_STEPS] [rt|rast] [RES]"
+    exit 1
+fi
+
+CONFIGS=""
+for N in ${GRIDS}; do
+    if [ "${RANDOM_PLACEMENT:-0}" = "1" ]; then
+        CONFIG=$((N * N))
+    else
+        CONFIG="${N}x${N}"
+    fi
+
+    CONFIGS="${CONFIGS:+${CONFIGS},}${CONFIG}"
+done
+
+GLB_INSTANCES=${CONFIGS} ./glb_headless \
+    ${NUM_WORLDS} ${NUM_STEPS} ${RENDER_MODE} ${RES} ${RES} ${GLB_PATH}
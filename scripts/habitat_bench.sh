@@ -0,0 +1,24 @@
+#!/bin/bash
+# Runs habitat_headless with and without pre-merged scene instances,
+# reporting init time and throughput for each configuration.
+# Run from the build/ directory:
+#   ../scripts/habitat_bench.sh [NUM_WORLDS] [NUM_STEPS] [rt|rast] [RES]
+#
+# MERGE_ALL (default "0 1") overrides the swept values. Scene selection
+# follows HSSD_FIRST_SCENE / HSSD_NUM_SCENES as usual. Each configuration
+# runs twice so the second run measures init from the baked asset cache.
+
+NUM_WORLDS=${1:-1024}
+NUM_STEPS=${2:-1000}
+RENDER_MODE=${3:-rt}
+RES=${4:-64}
+
+MERGE_ALL=${MERGE_ALL:-"0 1"}
+
+for MERGE in ${MERGE_ALL}; do
+    for RUN in 1 2; do
+        echo "HABITAT_MERGE_ALL=${MERGE} (run ${RUN})"
+        HABITAT_MERGE_ALL=${MERGE} ./habitat_headless \
+            ${NUM_WORLDS} ${NUM_STEPS} ${RENDER_MODE} ${RES} ${RES}
+    done
+done
@@ -0,0 +1,29 @@
+#!/bin/bash
+# Runs hideseek_headless over a matrix of physics solvers and wall merging,
+# reporting throughput and solver stability for each configuration.
+# Throughput is measured on the Train graph; the stability counters come
+# from a separate untimed Eval pass.
+# Run from the build/ directory:
+#   ../scripts/hideseek_bench.sh [NUM_WORLDS] [NUM_STEPS] [rt|rast] [RES]
+#
+# SOLVERS (default "xpbd tgs"), MERGE_WALLS (default "0 1") and SUBSTEPS
+# (default 4) override the swept values.
+
+NUM_WORLDS=${1:-1024}
+NUM_STEPS=${2:-1000}
+RENDER_MODE=${3:-rt}
+RES=${4:-64}
+
+SOLVERS=${SOLVERS:-"xpbd tgs"}
+MERGE_WALLS=${MERGE_WALLS:-"0 1"}
+SUBSTEPS=${SUBSTEPS:-4}
+
+for SOLVER in ${SOLVERS}; do
+    for MERGE in ${MERGE_WALLS}; do
+        echo "HIDESEEK_SOLVER=${SOLVER} HIDESEEK_MERGE_WALLS=${MERGE} HIDESEEK_SUBSTEPS=${SUBSTEPS}"
+        HIDESEEK_PHYSICS_STATS=1 \
+        HIDESEEK_SOLVER=${SOLVER} HIDESEEK_MERGE_WALLS=${MERGE} \
+        HIDESEEK_SUBSTEPS=${SUBSTEPS} ./hideseek_headless \
+            ${NUM_WORLDS} ${NUM_STEPS} ${RENDER_MODE} ${RES} ${RES}
+    done
+done